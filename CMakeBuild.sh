@@ -1,14 +1,16 @@
 #!/bin/bash
 #This is intended for Code-OSS tasks.json
-#CMakeBuild.sh [ALL,ACTIVE] [DEBUG, ASAN, RELEASE] [PATH TO main.c] [main.c BASENAME]
+#CMakeBuild.sh [ALL,ACTIVE] [DEBUG, ASAN, RELEASE] [PATH TO main.c] [main.c BASENAME] [OMP 0,1] [MEM_TRACK 0,1] [MEM_BUDGET banks]
 BUILD_WHAT="${1:-ALL}" #ALL: builds every .c source in SRC_DIR. ACTIVE: builds single source ${PROG}.c
 BUILD_TYPE="${2:-RELEASE}" #Type of build: DEBUG, ASAN, RELEASE. GCC debug/optimization flags
 SRC_DIR="${3:-./src}" #path to .c source. Uses ./include as .h directory
 PROG="${4:-''}" #Base name of .c file if using ACTIVE.
 USE_OMP="${5:-0}" 
+MEM_TRACK="${6:-0}" #1: count heap bytes per subsystem and report at exit
+MEM_BUDGET="${7:-0}" #Serve heap from this many 64 KiB banks, 0: system heap
 CONFIG=./CMakeLists.txt
 
-cmd="time cmake ${CONFIG} -DBUILD_WHAT=${BUILD_WHAT} -DBUILD_TYPE=${BUILD_TYPE} -DSRC_DIR=${SRC_DIR} -DPROG=${PROG} -DOMP_ENABLED=${USE_OMP}"
+cmd="time cmake ${CONFIG} -DBUILD_WHAT=${BUILD_WHAT} -DBUILD_TYPE=${BUILD_TYPE} -DSRC_DIR=${SRC_DIR} -DPROG=${PROG} -DOMP_ENABLED=${USE_OMP} -DMEM_TRACK=${MEM_TRACK} -DMEM_BUDGET=${MEM_BUDGET}"
 echo "$cmd"
 eval "$cmd"
 
@@ -0,0 +1,152 @@
+/**
+ * @file adaptive.c
+ *
+ * @brief Implementation, output buffer count chosen at runtime from measured underruns and render time
+ *
+ * Starts at the smallest buffer count. Any underrun or near full render load adds a block right away,
+ * while latency is lowered only after several quiet windows so it doesn't oscillate
+ */
+
+#include "kaelygon/audio/adaptive.h"
+
+#include <stdio.h>
+
+//------ Private ------
+
+void _kaelAudio_resetWindow(KaelAudio_adaptive *adaptive){
+	adaptive->blocks = 0;
+	adaptive->underruns = 0;
+	adaptive->peakLoad = 0;
+}
+
+void _kaelAudio_setBufferCount(KaelAudio_adaptive *adaptive, uint8_t count){
+	count = kaelMath_min(count, adaptive->maxCount);
+	count = kaelMath_max(count, adaptive->minCount);
+	if(count != adaptive->bufferCount){
+		adaptive->bufferCount = count;
+		adaptive->changes++;
+	}
+	adaptive->quietWindows = 0;
+	_kaelAudio_resetWindow(adaptive);
+}
+
+
+
+
+//------ Init ------
+
+/**
+ * @brief Init adaptive mode starting from minCount blocks
+ *
+ * @param blockSize samples per block, usually AUDIO_BUFFER_SIZE
+ */
+void kaelAudio_initAdaptive(KaelAudio_adaptive *adaptive, uint16_t blockSize, uint8_t minCount, uint8_t maxCount){
+	if(NULL_CHECK(adaptive)){return;}
+	*adaptive = (KaelAudio_adaptive){0};
+
+	adaptive->enabled = 1;
+	adaptive->blockSize = kaelMath_max(blockSize, 1);
+	adaptive->minCount = kaelMath_max(minCount, 1);
+	adaptive->maxCount = kaelMath_max(maxCount, adaptive->minCount);
+	adaptive->bufferCount = adaptive->minCount;
+}
+
+/**
+ * @brief Toggle adaptive mode. Disabled mode keeps fixedCount blocks
+ */
+void kaelAudio_setAdaptiveMode(KaelAudio_adaptive *adaptive, uint8_t enabled, uint8_t fixedCount){
+	if(NULL_CHECK(adaptive)){return;}
+	adaptive->enabled = enabled;
+	if(!enabled){
+		adaptive->bufferCount = kaelMath_max(fixedCount, 1);
+	}
+	adaptive->quietWindows = 0;
+	_kaelAudio_resetWindow(adaptive);
+}
+
+
+
+
+//------ Update ------
+
+/**
+ * @brief Report one played block
+ *
+ * @param underrun 1 if backend ran out of samples before this block
+ * @param renderTicks kaelClock ticks spent rendering the block. Clock runs at sample rate, so block duration is blockSize ticks
+ * @return 1 if buffer count changed, otherwise 0
+ */
+uint8_t kaelAudio_updateAdaptive(KaelAudio_adaptive *adaptive, uint8_t underrun, uint16_t renderTicks){
+	if(NULL_CHECK(adaptive)){return 0;}
+	adaptive->totalUnderruns += underrun!=0;
+	if(!adaptive->enabled){
+		return 0;
+	}
+
+	uint8_t oldCount = adaptive->bufferCount;
+
+	//render load scaled to 0-256
+	renderTicks = kaelMath_min(renderTicks, adaptive->blockSize);
+	uint16_t load = ((uint32_t)renderTicks<<8) / adaptive->blockSize;
+
+	adaptive->blocks++;
+	adaptive->underruns += underrun!=0;
+	adaptive->peakLoad = kaelMath_max(adaptive->peakLoad, load);
+
+	if(underrun || load >= KAEL_ADAPTIVE_GROW_LOAD){
+		_kaelAudio_setBufferCount(adaptive, oldCount+1);
+		return adaptive->bufferCount != oldCount;
+	}
+
+	if(adaptive->blocks < KAEL_ADAPTIVE_WINDOW){
+		return 0;
+	}
+
+	//Window end
+	uint8_t isQuiet = adaptive->underruns==0 && adaptive->peakLoad < KAEL_ADAPTIVE_SHRINK_LOAD;
+	adaptive->quietWindows = isQuiet ? adaptive->quietWindows+1 : 0;
+	_kaelAudio_resetWindow(adaptive);
+
+	if(adaptive->quietWindows >= KAEL_ADAPTIVE_SHRINK_WINDOWS){
+		_kaelAudio_setBufferCount(adaptive, oldCount-1);
+	}
+	return adaptive->bufferCount != oldCount;
+}
+
+
+
+
+//------ Report ------
+
+uint8_t kaelAudio_getBufferCount(const KaelAudio_adaptive *adaptive){
+	if(NULL_CHECK(adaptive)){return 0;}
+	return adaptive->bufferCount;
+}
+
+/**
+ * @brief Output latency in samples chosen at the moment, saturates at UINT16_MAX
+ */
+uint16_t kaelAudio_getLatencySamples(const KaelAudio_adaptive *adaptive){
+	if(NULL_CHECK(adaptive)){return 0;}
+	uint16_t maxCount = UINT16_MAX / adaptive->blockSize;
+	if(adaptive->bufferCount > maxCount){
+		return UINT16_MAX;
+	}
+	return adaptive->bufferCount * adaptive->blockSize;
+}
+
+/**
+ * @brief Output latency in milliseconds, rounded
+ */
+uint16_t kaelAudio_getLatencyMs(const KaelAudio_adaptive *adaptive){
+	uint32_t samples = kaelAudio_getLatencySamples(adaptive);
+	return (samples*1000 + AUDIO_SAMPLE_RATE/2) / AUDIO_SAMPLE_RATE;
+}
+
+void kaelAudio_printAdaptive(const KaelAudio_adaptive *adaptive){
+	if(NULL_CHECK(adaptive)){return;}
+	printf("Audio latency %u blocks, %u samples, %u ms. Underruns %u, changes %u\n",
+		adaptive->bufferCount, kaelAudio_getLatencySamples(adaptive), kaelAudio_getLatencyMs(adaptive),
+		adaptive->totalUnderruns, adaptive->changes
+	);
+}
@@ -0,0 +1,50 @@
+/**
+ * @file adaptive.h
+ *
+ * @brief Header, output buffer count chosen at runtime from measured underruns and render time
+ *
+ * Block length stays AUDIO_BUFFER_SIZE, latency is changed by how many blocks are queued in the backend
+ */
+#pragma once
+
+#include <stdint.h>
+
+#include "kaelygon/global/kaelMacros.h"
+#include "kaelygon/math/math.h"
+
+//Blocks between shrink decisions, 128 blocks of 256 samples = 1 second
+#define KAEL_ADAPTIVE_WINDOW 128U
+
+//Render load 0-256 where 256 = render took the whole block duration
+#define KAEL_ADAPTIVE_GROW_LOAD 230U //~90%
+#define KAEL_ADAPTIVE_SHRINK_LOAD 128U //50%
+
+//Quiet windows in a row before latency is lowered
+#define KAEL_ADAPTIVE_SHRINK_WINDOWS 4U
+
+typedef struct{
+	uint8_t enabled; //0 = bufferCount stays fixed
+	uint8_t bufferCount; //queued blocks, latency = bufferCount*blockSize
+	uint8_t minCount;
+	uint8_t maxCount;
+	uint16_t blockSize; //samples per block
+
+	//Current window
+	uint16_t blocks;
+	uint16_t underruns;
+	uint16_t peakLoad;
+	uint8_t quietWindows; //windows without underrun under shrink load
+
+	//Totals
+	uint16_t totalUnderruns;
+	uint16_t changes;
+}KaelAudio_adaptive;
+
+void kaelAudio_initAdaptive(KaelAudio_adaptive *adaptive, uint16_t blockSize, uint8_t minCount, uint8_t maxCount);
+void kaelAudio_setAdaptiveMode(KaelAudio_adaptive *adaptive, uint8_t enabled, uint8_t fixedCount);
+uint8_t kaelAudio_updateAdaptive(KaelAudio_adaptive *adaptive, uint8_t underrun, uint16_t renderTicks);
+
+uint8_t kaelAudio_getBufferCount(const KaelAudio_adaptive *adaptive);
+uint16_t kaelAudio_getLatencySamples(const KaelAudio_adaptive *adaptive);
+uint16_t kaelAudio_getLatencyMs(const KaelAudio_adaptive *adaptive);
+void kaelAudio_printAdaptive(const KaelAudio_adaptive *adaptive);
@@ -9,7 +9,8 @@
 
 #include "audioTypes.h"
 #include "waveform.h"
-#include "../kaelMacros.h"
+#include "kaelygon/global/kaelMacros.h"
+#include "kaelygon/mem/mem.h"
 
 void kaelAudio_init(KaelAudio* kaud){
     memset(kaud, 0, sizeof(KaelAudio));
@@ -44,16 +45,16 @@ void kaelAudio_init(KaelAudio* kaud){
 	
 	//MALLOC
 	kaud->wave.bufferSize = 256;
-	kaud->wave.phase = calloc( kaud->config.channels, sizeof(kaud->wave.phase[0]) );
+	kaud->wave.phase = KAEL_CALLOC(KAEL_MEM_AUDIO, kaud->config.channels, sizeof(kaud->wave.phase[0]) );
 	NULL_CHECK(kaud->wave.phase);
-	kaud->wave.buffer = calloc( kaud->wave.bufferSize, sizeof(kaud->wave.buffer[0]) );
+	kaud->wave.buffer = KAEL_CALLOC(KAEL_MEM_AUDIO, kaud->wave.bufferSize, sizeof(kaud->wave.buffer[0]) );
 	NULL_CHECK(kaud->wave.buffer);
 	
 }
 
 void kaelAudio_freeData(KaelAudio* kaud){
-	free(kaud->wave.phase);
-	free(kaud->wave.buffer);
+	KAEL_FREE(kaud->wave.phase);
+	KAEL_FREE(kaud->wave.buffer);
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,88 @@
+/**
+ * @file command.c
+ *
+ * @brief Implementation, lock-free single producer single consumer command queue
+ *
+ * Head and tail are free running 16-bit counters, their difference is the queue fill.
+ * Release store on the written index publishes the command slot, acquire load on the other side sees it.
+ */
+
+#include "kaelygon/audio/command.h"
+
+#define KAEL_COMMAND_QUEUE_MASK (KAEL_COMMAND_QUEUE_LENGTH-1)
+
+void kaelAudio_initQueue(KaelAudio_commandQueue *queue){
+	if(NULL_CHECK(queue)){return;}
+	atomic_init(&queue->head, 0);
+	atomic_init(&queue->tail, 0);
+	atomic_init(&queue->time, 0);
+}
+
+
+
+
+//------ Producer ------
+
+/**
+ * @brief Copy command to queue. Only one thread may push
+ * @return KAEL_SUCCESS, KAEL_ERR_FULL if the audio thread hasn't drained the queue
+ */
+uint8_t kaelAudio_pushCommand(KaelAudio_commandQueue *queue, const KaelAudio_command *cmd){
+	if(NULL_CHECK(queue) || NULL_CHECK(cmd)){return KAEL_ERR_NULL;}
+	uint16_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+	uint16_t head = atomic_load_explicit(&queue->head, memory_order_acquire);
+
+	if((uint16_t)(tail - head) >= KAEL_COMMAND_QUEUE_LENGTH){
+		return KAEL_ERR_FULL;
+	}
+
+	queue->cmd[tail & KAEL_COMMAND_QUEUE_MASK] = *cmd;
+	atomic_store_explicit(&queue->tail, tail+1, memory_order_release);
+	return KAEL_SUCCESS;
+}
+
+/**
+ * @brief Sample time of the block audio thread is rendering. Commands stamped earlier are applied late at block start
+ */
+uint16_t kaelAudio_getQueueTime(KaelAudio_commandQueue *queue){
+	if(NULL_CHECK(queue)){return 0;}
+	return atomic_load_explicit(&queue->time, memory_order_acquire);
+}
+
+
+
+
+//------ Consumer ------
+
+/**
+ * @brief Copy oldest command without removing it. Only one thread may consume
+ * @return 1 if command was copied, 0 if queue is empty
+ *
+ * @warning No NULL_CHECK
+ */
+uint8_t kaelAudio_peekCommand(KaelAudio_commandQueue *queue, KaelAudio_command *cmd){
+	KAEL_ASSERT(queue!=NULL && cmd!=NULL);
+	uint16_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+	uint16_t tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+	if(head==tail){
+		return 0;
+	}
+	*cmd = queue->cmd[head & KAEL_COMMAND_QUEUE_MASK];
+	return 1;
+}
+
+/**
+ * @brief Remove oldest command after it was peeked
+ *
+ * @warning No NULL_CHECK
+ */
+void kaelAudio_popCommand(KaelAudio_commandQueue *queue){
+	KAEL_ASSERT(queue!=NULL);
+	uint16_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+	atomic_store_explicit(&queue->head, head+1, memory_order_release);
+}
+
+void kaelAudio_setQueueTime(KaelAudio_commandQueue *queue, uint16_t time){
+	if(NULL_CHECK(queue)){return;}
+	atomic_store_explicit(&queue->time, time, memory_order_release);
+}
@@ -0,0 +1,49 @@
+/**
+ * @file command.h
+ *
+ * @brief Header, lock-free single producer single consumer command queue from UI/input thread to audio thread
+ *
+ * Neither side ever takes a lock. The UI pushes timestamped commands, the audio thread drains them at block start
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdatomic.h>
+
+#include "kaelygon/global/kaelMacros.h"
+
+//Power of two so indices wrap with a mask
+#define KAEL_COMMAND_QUEUE_LENGTH 64U
+
+typedef enum{
+	KAEL_CMD_NOTE_ON = 0, //value = pitch
+	KAEL_CMD_NOTE_OFF,
+	KAEL_CMD_VOLUME,
+	KAEL_CMD_PITCH,
+	KAEL_CMD_WAVEFORM,
+}KaelAudio_commandType;
+
+typedef struct{
+	uint16_t time; //sample time to apply the command at. Must be within half a wrap (~1 second) from now
+	uint8_t type; //KaelAudio_commandType
+	uint8_t track; //mixer track index
+	uint16_t value;
+}KaelAudio_command;
+
+typedef struct{
+	KaelAudio_command cmd[KAEL_COMMAND_QUEUE_LENGTH];
+	_Atomic uint16_t head; //next read, written only by audio thread
+	_Atomic uint16_t tail; //next write, written only by UI thread
+	_Atomic uint16_t time; //sample time at the start of the block being rendered, written only by audio thread
+}KaelAudio_commandQueue;
+
+void kaelAudio_initQueue(KaelAudio_commandQueue *queue);
+
+//------ Producer ------
+uint8_t kaelAudio_pushCommand(KaelAudio_commandQueue *queue, const KaelAudio_command *cmd);
+uint16_t kaelAudio_getQueueTime(KaelAudio_commandQueue *queue);
+
+//------ Consumer ------
+uint8_t kaelAudio_peekCommand(KaelAudio_commandQueue *queue, KaelAudio_command *cmd);
+void kaelAudio_popCommand(KaelAudio_commandQueue *queue);
+void kaelAudio_setQueueTime(KaelAudio_commandQueue *queue, uint16_t time);
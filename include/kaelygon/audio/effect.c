@@ -0,0 +1,198 @@
+/**
+ * @file effect.c
+ *
+ * @brief Implementation, send/return effects bus and feedback delay
+ *
+ * Bus cost depends only on block length and effect count, never on how many voices were mixed into the block.
+ * Each effect keeps its state in a small fixed buffer that stays in cache between blocks.
+ */
+
+#include "kaelygon/audio/effect.h"
+#include "kaelygon/mem/mem.h"
+
+
+
+
+//------ Sample arithmetic ------
+
+/**
+ * @brief Scale sample distance from silence by 0.16 fixed point gain
+ *
+ * dist*gain>>16 is split in high and low gain bytes so every product fits in 16 bits
+ */
+uint8_t kaelAudio_gainSample(uint8_t sample, uint16_t gain){
+	uint8_t isLow = sample < KAEL_AUDIO_SILENCE;
+	uint16_t dist = isLow ? KAEL_AUDIO_SILENCE - sample : sample - KAEL_AUDIO_SILENCE; //0 to 128
+
+	uint16_t scaled = dist*(gain>>8) + ((dist*(gain&0xFF))>>8);
+	scaled >>= 8;
+
+	return isLow ? KAEL_AUDIO_SILENCE - scaled : KAEL_AUDIO_SILENCE + scaled;
+}
+
+/**
+ * @brief Sum two samples around silence and clip to 8-bit
+ */
+uint8_t kaelAudio_mixSample(uint8_t a, uint8_t b){
+	uint16_t sum = (uint16_t)a + b; //silence is now at 256
+	if(sum < KAEL_AUDIO_SILENCE){
+		return 0;
+	}
+	sum -= KAEL_AUDIO_SILENCE;
+	return kaelMath_min(sum, UINT8_MAX);
+}
+
+
+
+
+//------ Delay ------
+
+/**
+ * @brief Allocate delay ring. Ring length is rounded up to power of two that fits delaySamples
+ *
+ * @param delaySamples echo distance, clamped to KAEL_DELAY_RING_MAX-1
+ * @param feedback 0.16 fixed point echo decay
+ * @return Kael_infoCode
+ */
+uint8_t kaelAudio_allocDelay(KaelAudio_delay *delay, uint16_t delaySamples, uint16_t feedback){
+	if(NULL_CHECK(delay)){return KAEL_ERR_NULL;}
+	*delay = (KaelAudio_delay){0};
+
+	delaySamples = kaelMath_min(delaySamples, KAEL_DELAY_RING_MAX-1);
+	delaySamples = kaelMath_max(delaySamples, 1);
+
+	uint16_t ringLength = 2;
+	while(ringLength <= delaySamples){
+		ringLength <<= 1;
+	}
+
+	delay->ring = KAEL_MALLOC(KAEL_MEM_AUDIO, ringLength*sizeof(uint8_t));
+	if(NULL_CHECK(delay->ring)){return KAEL_ERR_ALLOC;}
+	memset(delay->ring, KAEL_AUDIO_SILENCE, ringLength);
+
+	delay->mask = ringLength-1;
+	delay->delay = delaySamples;
+	delay->feedback = feedback;
+	return KAEL_SUCCESS;
+}
+
+void kaelAudio_freeDelay(KaelAudio_delay *delay){
+	if(NULL_CHECK(delay)){return;}
+	KAEL_FREE(delay->ring);
+	delay->ring = NULL;
+}
+
+void kaelAudio_setDelayFeedback(KaelAudio_delay *delay, uint16_t feedback){
+	if(NULL_CHECK(delay)){return;}
+	delay->feedback = feedback;
+}
+
+/**
+ * @brief KaelAudio_effectFunc, replace block with its echo. The echo is fed back to the ring scaled by feedback
+ *
+ * @warning No NULL_CHECK
+ */
+void kaelAudio_processDelay(void *state, uint8_t *block, uint16_t length){
+	KaelAudio_delay *delay = state;
+	KAEL_ASSERT(delay!=NULL && delay->ring!=NULL && block!=NULL);
+
+	uint8_t *ring = delay->ring;
+	const uint16_t mask = delay->mask;
+	const uint16_t feedback = delay->feedback;
+	uint16_t writePos = delay->writePos;
+	uint16_t readPos = (writePos - delay->delay) & mask;
+
+	for(uint16_t i=0; i<length; i++){
+		uint8_t wet = ring[readPos];
+		ring[writePos] = kaelAudio_mixSample(block[i], kaelAudio_gainSample(wet, feedback));
+		block[i] = wet;
+
+		writePos = (writePos+1) & mask;
+		readPos  = (readPos +1) & mask;
+	}
+	delay->writePos = writePos;
+}
+
+
+
+
+//------ Bus ------
+
+/**
+ * @brief Allocate bus send buffer. Blocks longer than blockSize are processed in blockSize parts
+ * @return Kael_infoCode
+ */
+uint8_t kaelAudio_allocBus(KaelAudio_bus *bus, uint16_t blockSize){
+	if(NULL_CHECK(bus)){return KAEL_ERR_NULL;}
+	*bus = (KaelAudio_bus){0};
+
+	bus->blockSize = kaelMath_max(blockSize, 1);
+	bus->sendBuf = KAEL_MALLOC(KAEL_MEM_AUDIO, bus->blockSize*sizeof(uint8_t));
+	if(NULL_CHECK(bus->sendBuf)){return KAEL_ERR_ALLOC;}
+
+	bus->send = UINT16_MAX;
+	bus->ret = UINT16_MAX;
+	return KAEL_SUCCESS;
+}
+
+/**
+ * @brief Free send buffer. Effect states are owned by the caller
+ */
+void kaelAudio_freeBus(KaelAudio_bus *bus){
+	if(NULL_CHECK(bus)){return;}
+	KAEL_FREE(bus->sendBuf);
+	*bus = (KaelAudio_bus){0};
+}
+
+/**
+ * @brief Append effect to end of the chain
+ * @return KAEL_SUCCESS, KAEL_ERR_FULL if all KAEL_BUS_SLOTS are taken
+ */
+uint8_t kaelAudio_addBusEffect(KaelAudio_bus *bus, KaelAudio_effectFunc func, void *state){
+	if(NULL_CHECK(bus) || func==NULL){return KAEL_ERR_NULL;}
+	if(bus->slotCount >= KAEL_BUS_SLOTS){
+		return KAEL_ERR_FULL;
+	}
+	bus->slot[bus->slotCount] = (KaelAudio_effectSlot){ .func = func, .state = state };
+	bus->slotCount++;
+	return KAEL_SUCCESS;
+}
+
+/**
+ * @brief Set 0.16 fixed point send and return levels
+ */
+void kaelAudio_setBusLevels(KaelAudio_bus *bus, uint16_t send, uint16_t ret){
+	if(NULL_CHECK(bus)){return;}
+	bus->send = send;
+	bus->ret = ret;
+}
+
+/**
+ * @brief Run mixed block through the bus in place. Call once per block after the mixer
+ */
+void kaelAudio_processBus(KaelAudio_bus *bus, uint8_t *block, uint16_t length){
+	if(NULL_CHECK(bus) || NULL_CHECK(block)){return;}
+	if(bus->slotCount==0){
+		return;
+	}
+
+	while(length > 0){
+		uint16_t partLength = kaelMath_min(length, bus->blockSize);
+		uint8_t *sendBuf = bus->sendBuf;
+
+		for(uint16_t i=0; i<partLength; i++){
+			sendBuf[i] = kaelAudio_gainSample(block[i], bus->send);
+		}
+
+		for(uint8_t s=0; s<bus->slotCount; s++){
+			bus->slot[s].func(bus->slot[s].state, sendBuf, partLength);
+		}
+
+		for(uint16_t i=0; i<partLength; i++){
+			block[i] = kaelAudio_mixSample(block[i], kaelAudio_gainSample(sendBuf[i], bus->ret));
+		}
+
+		block += partLength;
+		length -= partLength;
+	}
+}
@@ -0,0 +1,73 @@
+/**
+ * @file effect.h
+ *
+ * @brief Header, send/return effects bus processed per audio block
+ *
+ * Samples are unsigned 8-bit where kaelAudio_const.silentValue (128) is silence
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "kaelygon/global/kaelMacros.h"
+#include "kaelygon/math/math.h"
+
+#define KAEL_AUDIO_SILENCE 128U
+
+//Longest delay ring buffer in samples. Power of two, 1/4 second at 32768hz
+#define KAEL_DELAY_RING_MAX 8192U
+
+//Maximum number of effects in a single bus
+#define KAEL_BUS_SLOTS 4U
+
+//Effect callback, processes block in place
+typedef void (*KaelAudio_effectFunc)(void *state, uint8_t *block, uint16_t length);
+
+/**
+ * @brief Feedback delay, ring length is power of two so wrapping is a mask
+ */
+typedef struct{
+	uint8_t *ring; //delayed samples
+	uint16_t mask; //ring length -1
+	uint16_t writePos; //next write index
+	uint16_t delay; //delay in samples. Less than ring length
+	uint16_t feedback; //0.16 fixed point, 65535 = ~1.0
+}KaelAudio_delay;
+
+typedef struct{
+	KaelAudio_effectFunc func;
+	void *state;
+}KaelAudio_effectSlot;
+
+/**
+ * @brief Effects chain fed by a send from the mix and returned on top of the dry signal
+ */
+typedef struct{
+	KaelAudio_effectSlot slot[KAEL_BUS_SLOTS];
+	uint8_t slotCount;
+
+	uint16_t send; //0.16 fixed point dry->bus level
+	uint16_t ret; //0.16 fixed point bus->mix level
+
+	uint8_t *sendBuf; //wet signal of the current block
+	uint16_t blockSize; //sendBuf length
+}KaelAudio_bus;
+
+//------ Sample arithmetic ------
+uint8_t kaelAudio_gainSample(uint8_t sample, uint16_t gain);
+uint8_t kaelAudio_mixSample(uint8_t a, uint8_t b);
+
+//------ Delay ------
+uint8_t kaelAudio_allocDelay(KaelAudio_delay *delay, uint16_t delaySamples, uint16_t feedback);
+void kaelAudio_freeDelay(KaelAudio_delay *delay);
+void kaelAudio_setDelayFeedback(KaelAudio_delay *delay, uint16_t feedback);
+void kaelAudio_processDelay(void *state, uint8_t *block, uint16_t length);
+
+//------ Bus ------
+uint8_t kaelAudio_allocBus(KaelAudio_bus *bus, uint16_t blockSize);
+void kaelAudio_freeBus(KaelAudio_bus *bus);
+uint8_t kaelAudio_addBusEffect(KaelAudio_bus *bus, KaelAudio_effectFunc func, void *state);
+void kaelAudio_setBusLevels(KaelAudio_bus *bus, uint16_t send, uint16_t ret);
+void kaelAudio_processBus(KaelAudio_bus *bus, uint8_t *block, uint16_t length);
@@ -0,0 +1,301 @@
+/**
+ * @file mixer.c
+ *
+ * @brief Implementation, track mixer with optional worker thread rendering
+ *
+ * Tracks are independent until summation. Each render group writes only its own track buffers,
+ * then a single summation reads them in track index order on the calling thread.
+ */
+
+#include "kaelygon/audio/mixer.h"
+#include "kaelygon/mem/mem.h"
+
+
+
+
+//------ Private ------
+
+/**
+ * @brief Render every track of a group into current part of its buffer
+ */
+void _kaelAudio_renderGroup(KaelAudio_mixer *mixer, uint8_t group){
+	for(uint8_t t=group; t<mixer->trackCount; t+=mixer->groupCount){
+		KaelAudio_track *track = &mixer->track[t];
+		track->render(track->state, track->buffer + mixer->partOffset, mixer->partLength);
+	}
+}
+
+void *_kaelAudio_workerLoop(void *arg){
+	KaelAudio_worker *worker = arg;
+	KaelAudio_mixer *mixer = worker->mixer;
+	uint16_t renderedGeneration = 0;
+
+	pthread_mutex_lock(&mixer->lock);
+	while(1){
+		while(mixer->generation==renderedGeneration && !mixer->quit){
+			pthread_cond_wait(&mixer->startCond, &mixer->lock);
+		}
+		if(mixer->quit){
+			break;
+		}
+		renderedGeneration = mixer->generation;
+		pthread_mutex_unlock(&mixer->lock);
+
+		_kaelAudio_renderGroup(mixer, worker->group);
+
+		pthread_mutex_lock(&mixer->lock);
+		mixer->pending--;
+		if(mixer->pending==0){
+			pthread_cond_signal(&mixer->doneCond);
+		}
+	}
+	pthread_mutex_unlock(&mixer->lock);
+	return NULL;
+}
+
+
+
+
+//------ Alloc / Free ------
+
+/**
+ * @brief Allocate mixer and start groupCount-1 worker threads
+ *
+ * If a worker fails to start, the mixer runs with fewer groups. Output is the same either way
+ *
+ * @param blockSize longest block rendered at once, usually AUDIO_BUFFER_SIZE
+ * @param groupCount 1 renders everything on the calling thread
+ * @return Kael_infoCode
+ */
+uint8_t kaelAudio_allocMixer(KaelAudio_mixer *mixer, uint16_t blockSize, uint8_t groupCount){
+	if(NULL_CHECK(mixer)){return KAEL_ERR_NULL;}
+	*mixer = (KaelAudio_mixer){0};
+
+	mixer->blockSize = kaelMath_max(blockSize, 1);
+	groupCount = kaelMath_min(groupCount, KAEL_MIXER_GROUPS_MAX);
+	mixer->groupCount = 1;
+
+	if(groupCount<=1){
+		return KAEL_SUCCESS;
+	}
+
+	if( pthread_mutex_init(&mixer->lock, NULL) != 0 ){
+		return KAEL_ERR_ALLOC;
+	}
+	pthread_cond_init(&mixer->startCond, NULL);
+	pthread_cond_init(&mixer->doneCond, NULL);
+	mixer->threaded = 1;
+
+	for(uint8_t g=1; g<groupCount; g++){
+		KaelAudio_worker *worker = &mixer->worker[g];
+		worker->mixer = mixer;
+		worker->group = g;
+		if( pthread_create(&worker->thread, NULL, _kaelAudio_workerLoop, worker) != 0 ){
+			KAEL_ERROR_NOTE("kaelAudio_allocMixer worker thread failed\n");
+			worker->mixer = NULL;
+			break;
+		}
+		mixer->groupCount++;
+	}
+
+	return KAEL_SUCCESS;
+}
+
+/**
+ * @brief Stop workers and free track buffers. Track states are owned by the caller
+ */
+void kaelAudio_freeMixer(KaelAudio_mixer *mixer){
+	if(NULL_CHECK(mixer)){return;}
+
+	if(mixer->threaded){
+		pthread_mutex_lock(&mixer->lock);
+		mixer->quit = 1;
+		pthread_cond_broadcast(&mixer->startCond);
+		pthread_mutex_unlock(&mixer->lock);
+
+		for(uint8_t g=1; g<mixer->groupCount; g++){
+			pthread_join(mixer->worker[g].thread, NULL);
+		}
+		pthread_cond_destroy(&mixer->startCond);
+		pthread_cond_destroy(&mixer->doneCond);
+		pthread_mutex_destroy(&mixer->lock);
+	}
+
+	for(uint8_t t=0; t<mixer->trackCount; t++){
+		KAEL_FREE(mixer->track[t].buffer);
+	}
+	*mixer = (KaelAudio_mixer){0};
+}
+
+
+
+
+//------ Tracks ------
+
+/**
+ * @brief Add track. Tracks are summed in the order they are added
+ * @return KAEL_SUCCESS, KAEL_ERR_FULL if all KAEL_MIXER_TRACKS are taken
+ */
+uint8_t kaelAudio_addTrack(KaelAudio_mixer *mixer, KaelAudio_renderFunc render, void *state){
+	if(NULL_CHECK(mixer) || render==NULL){return KAEL_ERR_NULL;}
+	if(mixer->trackCount >= KAEL_MIXER_TRACKS){
+		return KAEL_ERR_FULL;
+	}
+
+	KaelAudio_track *track = &mixer->track[mixer->trackCount];
+	track->buffer = KAEL_MALLOC(KAEL_MEM_AUDIO, mixer->blockSize*sizeof(uint8_t));
+	if(NULL_CHECK(track->buffer)){return KAEL_ERR_ALLOC;}
+	memset(track->buffer, KAEL_AUDIO_SILENCE, mixer->blockSize);
+
+	track->render = render;
+	track->state = state;
+	mixer->trackCount++;
+	return KAEL_SUCCESS;
+}
+
+/**
+ * @brief Set callback that applies queued commands addressed to the track
+ * @return Kael_infoCode
+ */
+uint8_t kaelAudio_setTrackApply(KaelAudio_mixer *mixer, uint8_t trackIndex, KaelAudio_applyFunc apply){
+	if(NULL_CHECK(mixer)){return KAEL_ERR_NULL;}
+	if(trackIndex >= mixer->trackCount){
+		return KAEL_ERR_FULL;
+	}
+	mixer->track[trackIndex].apply = apply;
+	return KAEL_SUCCESS;
+}
+
+uint8_t kaelAudio_getTrackCount(const KaelAudio_mixer *mixer){
+	if(NULL_CHECK(mixer)){return 0;}
+	return mixer->trackCount;
+}
+
+
+
+
+//------ Mixing ------
+
+/**
+ * @brief Render every track to buffer range [offset, offset+length) using all render groups
+ *
+ * @warning No NULL_CHECK. offset+length must not exceed blockSize
+ */
+void kaelAudio_renderTracks(KaelAudio_mixer *mixer, uint16_t offset, uint16_t length){
+	KAEL_ASSERT(mixer!=NULL);
+	KAEL_ASSERT(offset+length <= mixer->blockSize, "kaelAudio_renderTracks out of bounds");
+	mixer->partOffset = offset;
+	mixer->partLength = length;
+
+	if(mixer->groupCount==1){
+		_kaelAudio_renderGroup(mixer, 0);
+		return;
+	}
+
+	pthread_mutex_lock(&mixer->lock);
+	mixer->pending = mixer->groupCount-1;
+	mixer->generation++;
+	pthread_cond_broadcast(&mixer->startCond);
+	pthread_mutex_unlock(&mixer->lock);
+
+	_kaelAudio_renderGroup(mixer, 0);
+
+	pthread_mutex_lock(&mixer->lock);
+	while(mixer->pending > 0){
+		pthread_cond_wait(&mixer->doneCond, &mixer->lock);
+	}
+	pthread_mutex_unlock(&mixer->lock);
+}
+
+/**
+ * @brief Sum first length samples of track buffers in track order and clip to 8-bit
+ *
+ * @warning No NULL_CHECK
+ */
+void kaelAudio_sumTracks(KaelAudio_mixer *mixer, uint8_t *out, uint16_t length){
+	KAEL_ASSERT(mixer!=NULL && out!=NULL);
+	if(mixer->trackCount==0){
+		memset(out, KAEL_AUDIO_SILENCE, length);
+		return;
+	}
+
+	//Every track adds one silence offset, 16 tracks * 255 fits in 16 bits
+	const uint16_t offset = KAEL_AUDIO_SILENCE * (mixer->trackCount-1);
+	for(uint16_t i=0; i<length; i++){
+		uint16_t acc = 0;
+		for(uint8_t t=0; t<mixer->trackCount; t++){
+			acc += mixer->track[t].buffer[i];
+		}
+		acc = kaelMath_sub(acc, offset);
+		out[i] = kaelMath_min(acc, UINT8_MAX);
+	}
+}
+
+/**
+ * @brief Apply command to its track. Commands to unknown tracks are dropped
+ */
+void _kaelAudio_applyCommand(KaelAudio_mixer *mixer, const KaelAudio_command *cmd){
+	if(cmd->track >= mixer->trackCount){
+		return;
+	}
+	KaelAudio_track *track = &mixer->track[cmd->track];
+	if(track->apply!=NULL){
+		track->apply(track->state, cmd);
+	}
+}
+
+/**
+ * @brief Render and mix length samples to out. Blocks longer than blockSize are mixed in parts
+ */
+void kaelAudio_mixBlock(KaelAudio_mixer *mixer, uint8_t *out, uint16_t length){
+	if(NULL_CHECK(mixer) || NULL_CHECK(out)){return;}
+
+	while(length > 0){
+		uint16_t partLength = kaelMath_min(length, mixer->blockSize);
+		kaelAudio_renderTracks(mixer, 0, partLength);
+		kaelAudio_sumTracks(mixer, out, partLength);
+		out += partLength;
+		length -= partLength;
+	}
+}
+
+/**
+ * @brief Drain commands due in this block and mix it. Tracks are rendered in parts split at command times so every command lands on its exact sample
+ *
+ * Commands stamped before the block are applied at block start. Commands due after the block are left in queue
+ * Call only from the audio thread, it's the only queue consumer
+ */
+void kaelAudio_mixQueued(KaelAudio_mixer *mixer, KaelAudio_commandQueue *queue, uint8_t *out, uint16_t length){
+	if(NULL_CHECK(mixer) || NULL_CHECK(queue) || NULL_CHECK(out)){return;}
+
+	while(length > 0){
+		uint16_t blockLength = kaelMath_min(length, mixer->blockSize);
+		uint16_t blockStart = kaelAudio_getQueueTime(queue);
+		uint16_t pos = 0;
+
+		while(pos < blockLength){
+			uint16_t partEnd = blockLength;
+			KaelAudio_command cmd;
+
+			while(kaelAudio_peekCommand(queue, &cmd)){
+				uint16_t due = cmd.time - blockStart; //wrap safe distance from block start
+				due = kaelMath_isNegative(due) ? pos : kaelMath_max(due, pos); //late commands apply now
+				if(due > pos){
+					partEnd = kaelMath_min(due, blockLength);
+					break;
+				}
+				_kaelAudio_applyCommand(mixer, &cmd);
+				kaelAudio_popCommand(queue);
+			}
+
+			kaelAudio_renderTracks(mixer, pos, partEnd-pos);
+			pos = partEnd;
+		}
+
+		kaelAudio_sumTracks(mixer, out, blockLength);
+		kaelAudio_setQueueTime(queue, blockStart+blockLength);
+
+		out += blockLength;
+		length -= blockLength;
+	}
+}
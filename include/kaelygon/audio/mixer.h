@@ -0,0 +1,84 @@
+/**
+ * @file mixer.h
+ *
+ * @brief Header, track mixer with optional worker thread rendering
+ *
+ * Tracks are rendered into their own buffers and summed in track order,
+ * so output is bit-identical regardless of how many threads rendered it
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "kaelygon/global/kaelMacros.h"
+#include "kaelygon/math/math.h"
+#include "kaelygon/audio/effect.h"
+#include "kaelygon/audio/command.h"
+
+//Readme goal is 8 tracks, rendering groups can raise polyphony beyond it on desktop
+#define KAEL_MIXER_TRACKS 16U
+
+//Render groups including the calling thread
+#define KAEL_MIXER_GROUPS_MAX 4U
+
+//Track callback, writes length samples to block
+typedef void (*KaelAudio_renderFunc)(void *state, uint8_t *block, uint16_t length);
+
+//Track callback, applies queued command to track state between rendered parts
+typedef void (*KaelAudio_applyFunc)(void *state, const KaelAudio_command *cmd);
+
+typedef struct{
+	KaelAudio_renderFunc render;
+	KaelAudio_applyFunc apply; //optional
+	void *state; //owned by caller
+	uint8_t *buffer; //blockSize samples, rendered before summation
+}KaelAudio_track;
+
+typedef struct KaelAudio_mixer KaelAudio_mixer;
+
+typedef struct{
+	KaelAudio_mixer *mixer;
+	pthread_t thread;
+	uint8_t group; //renders tracks where index % groupCount == group
+}KaelAudio_worker;
+
+struct KaelAudio_mixer{
+	KaelAudio_track track[KAEL_MIXER_TRACKS];
+	uint8_t trackCount;
+	uint16_t blockSize; //longest part rendered at once
+
+	//Range of track buffers the groups are rendering
+	uint16_t partOffset;
+	uint16_t partLength;
+
+	//Group 0 is the calling thread, others have a worker thread
+	uint8_t groupCount;
+	KaelAudio_worker worker[KAEL_MIXER_GROUPS_MAX];
+
+	//Worker hand off. Only the audio thread and its workers take the lock
+	pthread_mutex_t lock;
+	pthread_cond_t startCond;
+	pthread_cond_t doneCond;
+	uint16_t generation; //incremented for every part to render
+	uint8_t pending; //workers still rendering current part
+	uint8_t threaded; //lock and conditions are initialized
+	uint8_t quit;
+};
+
+//------ Alloc / Free ------
+uint8_t kaelAudio_allocMixer(KaelAudio_mixer *mixer, uint16_t blockSize, uint8_t groupCount);
+void kaelAudio_freeMixer(KaelAudio_mixer *mixer);
+
+//------ Tracks ------
+uint8_t kaelAudio_addTrack(KaelAudio_mixer *mixer, KaelAudio_renderFunc render, void *state);
+uint8_t kaelAudio_setTrackApply(KaelAudio_mixer *mixer, uint8_t trackIndex, KaelAudio_applyFunc apply);
+uint8_t kaelAudio_getTrackCount(const KaelAudio_mixer *mixer);
+
+//------ Mixing ------
+void kaelAudio_renderTracks(KaelAudio_mixer *mixer, uint16_t offset, uint16_t length);
+void kaelAudio_sumTracks(KaelAudio_mixer *mixer, uint8_t *out, uint16_t length);
+void kaelAudio_mixBlock(KaelAudio_mixer *mixer, uint8_t *out, uint16_t length);
+void kaelAudio_mixQueued(KaelAudio_mixer *mixer, KaelAudio_commandQueue *queue, uint8_t *out, uint16_t length);
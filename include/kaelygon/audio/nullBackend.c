@@ -0,0 +1,154 @@
+/**
+ * @file nullBackend.c
+ *
+ * @brief Implementation, audio backend that plays blocks into nothing or a raw PCM file at real time pace
+ *
+ * The emulated device plays sample n at startNs + n/AUDIO_SAMPLE_RATE.
+ * Writing blocks while bufferCount blocks are still queued sleeps like a blocking snd_pcm_writei would
+ */
+
+#include "kaelygon/audio/nullBackend.h"
+#include "kaelygon/audio/effect.h"
+#include "kaelygon/math/math.h"
+
+#define KAEL_NS_PER_SECOND 1000000000ULL
+
+//------ Private ------
+
+/**
+ * @brief Play time of nth sample since device start
+ */
+uint64_t _kaelAudio_sampleNs(const KaelAudio_nullBackend *backend, uint64_t sample){
+	return backend->startNs + sample*KAEL_NS_PER_SECOND/AUDIO_SAMPLE_RATE;
+}
+
+void _kaelAudio_sleepUntilNs(uint64_t wakeNs){
+	struct timespec wake = {
+		.tv_sec  = wakeNs / KAEL_NS_PER_SECOND,
+		.tv_nsec = wakeNs % KAEL_NS_PER_SECOND
+	};
+	while( clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, NULL) != 0 ){}
+}
+
+
+
+
+//------ Open / Close ------
+
+uint64_t kaelAudio_monotonicNs(){
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec*KAEL_NS_PER_SECOND + now.tv_nsec;
+}
+
+/**
+ * @brief Start emulated device. Playback clock starts now
+ *
+ * @param path raw PCM output file or NULL to discard samples
+ * @return Kael_infoCode
+ */
+uint8_t kaelAudio_openNullBackend(KaelAudio_nullBackend *backend, uint16_t blockSize, uint8_t bufferCount, const char *path){
+	if(NULL_CHECK(backend)){return KAEL_ERR_NULL;}
+	*backend = (KaelAudio_nullBackend){0};
+
+	if(path!=NULL){
+		backend->file = fopen(path, "wb");
+		if(NULL_CHECK(backend->file)){return KAEL_ERR_ALLOC;}
+	}
+
+	backend->blockSize = kaelMath_max(blockSize, 1);
+	backend->bufferCount = kaelMath_max(bufferCount, 1);
+	backend->startNs = kaelAudio_monotonicNs();
+	return KAEL_SUCCESS;
+}
+
+void kaelAudio_closeNullBackend(KaelAudio_nullBackend *backend){
+	if(NULL_CHECK(backend)){return;}
+	if(backend->file!=NULL){
+		fclose(backend->file);
+	}
+	backend->file = NULL;
+}
+
+/**
+ * @brief Change queue depth, e.g. from KaelAudio_adaptive
+ */
+void kaelAudio_setNullBufferCount(KaelAudio_nullBackend *backend, uint8_t bufferCount){
+	if(NULL_CHECK(backend)){return;}
+	backend->bufferCount = kaelMath_max(bufferCount, 1);
+}
+
+
+
+
+//------ Playback ------
+
+/**
+ * @brief Queue block for playback. Sleeps while the device queue is full
+ * @return 1 if the device had run dry before this block (underrun), otherwise 0
+ */
+uint8_t kaelAudio_writeNullBackend(KaelAudio_nullBackend *backend, const uint8_t *block, uint16_t length){
+	if(NULL_CHECK(backend) || NULL_CHECK(block)){return 0;}
+
+	uint64_t queuedSamples = (uint64_t)backend->bufferCount * backend->blockSize;
+	uint64_t nowNs = kaelAudio_monotonicNs();
+	uint64_t playedSamples = (nowNs - backend->startNs) * AUDIO_SAMPLE_RATE / KAEL_NS_PER_SECOND;
+
+	uint8_t underrun = 0;
+	if(playedSamples > backend->writtenSamples){
+		//Device played silence, restart its clock from this block like snd_pcm_prepare
+		underrun = backend->writtenSamples!=0;
+		backend->underruns += underrun;
+		backend->startNs = nowNs - backend->writtenSamples*KAEL_NS_PER_SECOND/AUDIO_SAMPLE_RATE;
+	}else if(backend->writtenSamples >= playedSamples + queuedSamples){
+		//Queue is full, wait until one block worth has played
+		_kaelAudio_sleepUntilNs( _kaelAudio_sampleNs(backend, backend->writtenSamples + length - queuedSamples) );
+	}
+
+	if(atomic_load(&backend->armed)){
+		uint8_t threshold = atomic_load(&backend->threshold);
+		for(uint16_t i=0; i<length; i++){
+			uint8_t dist = block[i] > KAEL_AUDIO_SILENCE ? block[i]-KAEL_AUDIO_SILENCE : KAEL_AUDIO_SILENCE-block[i];
+			if(dist > threshold){
+				atomic_store(&backend->onsetNs, _kaelAudio_sampleNs(backend, backend->writtenSamples + i));
+				atomic_store(&backend->armed, 0);
+				break;
+			}
+		}
+	}
+
+	if(backend->file!=NULL){
+		fwrite(block, sizeof(uint8_t), length, backend->file);
+	}
+	backend->writtenSamples += length;
+	return underrun;
+}
+
+
+
+
+//------ Onset detection ------
+
+/**
+ * @brief Look for the first sample further than threshold from silence in following blocks
+ */
+void kaelAudio_armOnset(KaelAudio_nullBackend *backend, uint8_t threshold){
+	if(NULL_CHECK(backend)){return;}
+	atomic_store(&backend->threshold, threshold);
+	atomic_store(&backend->onsetNs, 0);
+	atomic_store(&backend->armed, 1);
+}
+
+/**
+ * @brief Get play time of detected onset
+ * @return 1 if onset was found since arming, otherwise 0
+ */
+uint8_t kaelAudio_getOnset(KaelAudio_nullBackend *backend, uint64_t *onsetNs){
+	if(NULL_CHECK(backend) || NULL_CHECK(onsetNs)){return 0;}
+	uint64_t onset = atomic_load(&backend->onsetNs);
+	if(atomic_load(&backend->armed) || onset==0){
+		return 0;
+	}
+	*onsetNs = onset;
+	return 1;
+}
@@ -0,0 +1,43 @@
+/**
+ * @file nullBackend.h
+ *
+ * @brief Header, audio backend that plays blocks into nothing or a raw PCM file at real time pace
+ *
+ * Emulates a sound card queue of bufferCount blocks, so the time each sample would leave the speaker is known.
+ * Used to measure latency without audio hardware
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdatomic.h>
+#include <time.h>
+
+#include "kaelygon/global/kaelMacros.h"
+
+typedef struct{
+	FILE *file; //optional raw 8-bit PCM output
+	uint16_t blockSize; //samples per block
+	uint8_t bufferCount; //blocks the emulated device queues
+
+	uint64_t startNs; //device playback start time
+	uint64_t writtenSamples; //samples handed to the device since start
+
+	//Onset detection, armed from any thread while audio thread writes
+	_Atomic uint8_t threshold; //distance from silence that counts as sound
+	_Atomic uint8_t armed; //1 = looking for first non-silent sample
+	_Atomic uint64_t onsetNs; //play time of the first non-silent sample after arming
+
+	uint16_t underruns;
+}KaelAudio_nullBackend;
+
+uint64_t kaelAudio_monotonicNs();
+
+uint8_t kaelAudio_openNullBackend(KaelAudio_nullBackend *backend, uint16_t blockSize, uint8_t bufferCount, const char *path);
+void kaelAudio_closeNullBackend(KaelAudio_nullBackend *backend);
+void kaelAudio_setNullBufferCount(KaelAudio_nullBackend *backend, uint8_t bufferCount);
+
+uint8_t kaelAudio_writeNullBackend(KaelAudio_nullBackend *backend, const uint8_t *block, uint16_t length);
+
+void kaelAudio_armOnset(KaelAudio_nullBackend *backend, uint8_t threshold);
+uint8_t kaelAudio_getOnset(KaelAudio_nullBackend *backend, uint64_t *onsetNs);
@@ -0,0 +1,111 @@
+/**
+ * @file voice.c
+ *
+ * @brief Implementation, mixer track that plays the waveform generator in audio.h
+ *
+ * Voice parameters are changed only through queued commands, so the UI never writes KaelAudio fields directly
+ */
+
+#include "kaelygon/audio/voice.h"
+#include "kaelygon/math/math.h"
+#include "kaelygon/mem/mem.h"
+
+#include "kaelygon/audio/audio.h"
+#include "kaelygon/audio/tone.h"
+
+#define KAEL_VOICE_PITCH_MASK 0b111111U
+#define KAEL_VOICE_VOLUME_SHIFT 6U
+#define KAEL_VOICE_TYPE_SHIFT 12U
+
+uint8_t kaelAudio_allocVoice(KaelAudio_voice *voice){
+	if(NULL_CHECK(voice)){return KAEL_ERR_NULL;}
+	*voice = (KaelAudio_voice){0};
+
+	voice->synth = KAEL_MALLOC(KAEL_MEM_AUDIO, sizeof(KaelAudio));
+	if(NULL_CHECK(voice->synth)){return KAEL_ERR_ALLOC;}
+	kaelAudio_init(voice->synth);
+	if(voice->synth->wave.phase==NULL || voice->synth->wave.buffer==NULL){
+		kaelAudio_freeVoice(voice);
+		return KAEL_ERR_ALLOC;
+	}
+
+	voice->info = voice->synth->wave.info.u16;
+	return KAEL_SUCCESS;
+}
+
+void kaelAudio_freeVoice(KaelAudio_voice *voice){
+	if(NULL_CHECK(voice) || NULL_CHECK(voice->synth)){return;}
+	kaelAudio_freeData(voice->synth);
+	KAEL_FREE(voice->synth);
+	voice->synth = NULL;
+}
+
+/**
+ * @brief KaelAudio_renderFunc, silence while gate is closed
+ *
+ * @warning No NULL_CHECK
+ */
+void kaelAudio_renderVoice(void *state, uint8_t *block, uint16_t length){
+	KaelAudio_voice *voice = state;
+	KAEL_ASSERT(voice!=NULL && voice->synth!=NULL && block!=NULL);
+
+	if(!voice->gate){
+		memset(block, kaelAudio_const.silentValue, length);
+		return;
+	}
+
+	KaelAudio *synth = voice->synth;
+	synth->wave.info.u16 = voice->info;
+
+	//Synth buffer is 256 samples, longer parts are generated in pieces
+	const uint16_t synthSize = 256;
+	while(length > 0){
+		uint16_t partLength = kaelMath_min(length, synthSize);
+		synth->wave.bufferSize = partLength;
+		kaelAudio_toneGen(synth, 0);
+		memcpy(block, synth->wave.buffer, partLength);
+		block += partLength;
+		length -= partLength;
+	}
+	synth->wave.bufferSize = synthSize;
+}
+
+/**
+ * @brief KaelAudio_applyFunc, change voice parameters
+ *
+ * @warning No NULL_CHECK
+ */
+void kaelAudio_applyVoice(void *state, const KaelAudio_command *cmd){
+	KaelAudio_voice *voice = state;
+	KAEL_ASSERT(voice!=NULL && cmd!=NULL);
+
+	const uint16_t pitchBits  = KAEL_VOICE_PITCH_MASK;
+	const uint16_t volumeBits = KAEL_VOICE_PITCH_MASK << KAEL_VOICE_VOLUME_SHIFT;
+	const uint16_t typeBits   = 0b1111U << KAEL_VOICE_TYPE_SHIFT;
+
+	switch(cmd->type){
+		case KAEL_CMD_NOTE_ON:
+			voice->info = (voice->info & ~pitchBits) | (cmd->value & pitchBits);
+			voice->gate = 1;
+			break;
+
+		case KAEL_CMD_NOTE_OFF:
+			voice->gate = 0;
+			break;
+
+		case KAEL_CMD_VOLUME:
+			voice->info = (voice->info & ~volumeBits) | ((cmd->value << KAEL_VOICE_VOLUME_SHIFT) & volumeBits);
+			break;
+
+		case KAEL_CMD_PITCH:
+			voice->info = (voice->info & ~pitchBits) | (cmd->value & pitchBits);
+			break;
+
+		case KAEL_CMD_WAVEFORM:
+			voice->info = (voice->info & ~typeBits) | ((cmd->value << KAEL_VOICE_TYPE_SHIFT) & typeBits);
+			break;
+
+		default:
+			break;
+	}
+}
@@ -0,0 +1,27 @@
+/**
+ * @file voice.h
+ *
+ * @brief Header, mixer track that plays the waveform generator in audio.h
+ */
+#pragma once
+
+#include <stdint.h>
+
+#include "kaelygon/global/kaelMacros.h"
+#include "kaelygon/audio/command.h"
+
+//audio.h defines its functions and tables in header, so only voice.c may include it
+typedef struct KaelAudio KaelAudio;
+
+typedef struct{
+	KaelAudio *synth; //wave generator state
+	uint16_t info; //type<<12 | volume<<6 | pitch<<0, same as KaelAudio_waveData.info
+	uint8_t gate; //1 = note is playing
+}KaelAudio_voice;
+
+uint8_t kaelAudio_allocVoice(KaelAudio_voice *voice);
+void kaelAudio_freeVoice(KaelAudio_voice *voice);
+
+//KaelAudio_renderFunc and KaelAudio_applyFunc
+void kaelAudio_renderVoice(void *state, uint8_t *block, uint16_t length);
+void kaelAudio_applyVoice(void *state, const KaelAudio_command *cmd);
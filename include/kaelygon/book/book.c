@@ -18,14 +18,14 @@
  * @brief free page trees
  */
 void kaelBook_freePage(KaelBook_page *page){
-	while(!kaelTree_empty(&page->shape)){
-		KaelBook_shape *curShape = kaelTree_back(&page->shape);
+	while(!kaelDeque_empty(&page->shape)){
+		KaelBook_shape *curShape = kaelDeque_back(&page->shape);
 		if(curShape->ownsString){
-			free(curShape->string);
+			KAEL_FREE(curShape->string);
 		}
-		kaelTree_pop(&page->shape);
+		kaelDeque_popBack(&page->shape);
 	}
-	kaelTree_free(&page->shape);
+	kaelDeque_free(&page->shape);
 }
 
 /**
@@ -45,7 +45,7 @@ uint8_t kaelBook_allocBook(KaelBook *book, const uint16_t viewWidth, const uint1
 
 	if(stringBuffer==NULL){
 		//Heap allocation
-		book->rowBuf.s = calloc(book->rowBuf.size, sizeof(uint8_t));
+		book->rowBuf.s = KAEL_CALLOC(KAEL_MEM_BOOK, book->rowBuf.size, sizeof(uint8_t));
 
 		code = NULL_CHECK(book->rowBuf.s) ? KAEL_ERR_NULL : code;
 		if(NULL_CHECK(book->rowBuf.s)){ 
@@ -64,10 +64,7 @@ uint8_t kaelBook_allocBook(KaelBook *book, const uint16_t viewWidth, const uint1
 	code = kaelTree_alloc(&book->page, sizeof(KaelBook_page));
 	if(code != KAEL_SUCCESS){ goto label_pageFail; }
 
-	code = kaelTree_alloc(&book->drawQueue, sizeof(KaelBook_shape));
-	if(code != KAEL_SUCCESS){ goto label_drawQueueFail; }
-
-	code = kaelTree_reserve(&book->drawQueue, 8);
+	code = kaelTree_shapeQueue_alloc(&book->drawQueue); //Inline, no allocation until queue outgrows it
 	if(code != KAEL_SUCCESS){ goto label_drawQueueFail; }
 	
 	return code;
@@ -78,7 +75,7 @@ uint8_t kaelBook_allocBook(KaelBook *book, const uint16_t viewWidth, const uint1
 
 	label_pageFail:
 	if(book->rowBuf.ownsBuffer){
-		free(book->rowBuf.s);
+		KAEL_FREE(book->rowBuf.s);
 	}
 
 	label_rowBufFail:
@@ -94,17 +91,17 @@ void kaelBook_freeBook(KaelBook *book){
 	}
 
 	kaelTree_free(&book->page);
-	kaelTree_free(&book->drawQueue);
+	kaelTree_shapeQueue_free(&book->drawQueue);
 
 	if(book->rowBuf.ownsBuffer){
-		free(book->rowBuf.s);
+		KAEL_FREE(book->rowBuf.s);
 		book->rowBuf.s=NULL;
 	}
 	book->rowBuf.readPtr=NULL;
 }
 
 void kaelBook_allocPage(KaelBook_page *page){
-	kaelTree_alloc(&page->shape, sizeof(KaelBook_shape));
+	kaelDeque_alloc(&page->shape, sizeof(KaelBook_shape));
 }
 
 
@@ -186,16 +183,18 @@ uint8_t kaelBook_isBelowShape(KaelBook *book, KaelBook_shape *shapePtr, uint16_t
 
 /**
  * @brief What shape is at viewport char col/row? (view space)
+ * @return Shape id or KAEL_BOOK_NO_SHAPE
  */
-KaelBook_shape *kaelBook_getShapeAt(KaelBook *book, uint16_t viewCol, uint16_t viewRow){
+KaelBook_shapeId kaelBook_getShapeAt(KaelBook *book, uint16_t viewCol, uint16_t viewRow){
 	KAEL_ASSERT(book!=NULL);
 	uint16_t bookX = book->viewPos[0] + viewCol;
 	uint16_t bookY = book->viewPos[1] + viewRow;
 
 	KaelBook_page *pagePtr = kaelTree_get(&book->page, book->index);
-	KaelBook_shape *shapePtr = kaelTree_begin(&pagePtr->shape);
+	KaelBook_shapeId shapeCount = kaelBook_shapeCount(pagePtr);
 
-	while(shapePtr){
+	for(KaelBook_shapeId i=0; i<shapeCount; i++){
+		KaelBook_shape *shapePtr = kaelDeque_get(&pagePtr->shape, i);
 		//shape corners
 		uint16_t shapeX0 = shapePtr->pos[0]; 
 		uint16_t shapeY0 = shapePtr->pos[1];
@@ -208,13 +207,62 @@ KaelBook_shape *kaelBook_getShapeAt(KaelBook *book, uint16_t viewCol, uint16_t v
 			bookY  < shapeY1
 		 ){
 			//Return first instance
-			return shapePtr;
+			return i;
 		}
-		kaelTree_next(&pagePtr->shape, (void**)&shapePtr);
 	}
 
-	//Returns NULL if no match
-	return shapePtr;
+	return KAEL_BOOK_NO_SHAPE;
+}
+
+/**
+ * @brief Number of shapes in page, every shape id is below it
+ *
+ * @warning No NULL_CHECK
+ */
+KaelBook_shapeId kaelBook_shapeCount(const KaelBook_page *page){
+	KAEL_ASSERT(page!=NULL);
+	uint32_t shapeCount = kaelDeque_length(&page->shape);
+	KAEL_ASSERT(shapeCount < KAEL_BOOK_NO_SHAPE, "Page has more shapes than KaelBook_shapeId can address");
+	return (KaelBook_shapeId)shapeCount;
+}
+
+/**
+ * @brief Shape of current page by id
+ *
+ * @warning No NULL_CHECK
+ */
+KaelBook_shape *kaelBook_getShape(KaelBook *book, KaelBook_shapeId id){
+	KAEL_ASSERT(book!=NULL);
+	KaelBook_page *pagePtr = kaelTree_get(&book->page, book->index);
+	return kaelDeque_get(&pagePtr->shape, id);
+}
+
+/**
+ * @brief Add shape of current page to drawQueue. Shape that is already queued is skipped
+ * @return Kael_infoCode
+ */
+uint8_t kaelBook_queueShape(KaelBook *book, KaelBook_shapeId id){
+	if(NULL_CHECK(book)){return KAEL_ERR_NULL;}
+	KaelBook_shape *shapePtr = kaelBook_getShape(book, id);
+	if(shapePtr->flags & KAEL_BOOK_SHAPE_QUEUED){
+		return KAEL_SUCCESS;
+	}
+	if(kaelTree_shapeQueue_push(&book->drawQueue, id)==NULL){
+		return KAEL_ERR_FULL;
+	}
+	shapePtr->flags |= KAEL_BOOK_SHAPE_QUEUED;
+	return KAEL_SUCCESS;
+}
+
+/**
+ * @brief Empty drawQueue without drawing
+ */
+void kaelBook_clearQueue(KaelBook *book){
+	if(NULL_CHECK(book)){return;}
+	KAEL_TREE_FOREACH(id, &book->drawQueue){
+		kaelBook_getShape(book, *id)->flags &= ~KAEL_BOOK_SHAPE_QUEUED;
+	}
+	kaelTree_shapeQueue_clear(&book->drawQueue);
 }
 
 
@@ -302,7 +350,7 @@ void kaelBook_pushMovInShape(KaelBook *book, KaelBook_shape *shapePtr, uint16_t
 void kaelBook_scrollRows(KaelBook *book, uint16_t scrollCount, uint16_t scrollUp){
 	if(scrollCount==0){return;}
 	KaelBook_page *pagePtr = kaelTree_get(&book->page, book->index);
-	if(kaelTree_empty(&pagePtr->shape)){
+	if(kaelDeque_empty(&pagePtr->shape)){
 		return;
 	}
 
@@ -331,13 +379,13 @@ void kaelBook_scrollRows(KaelBook *book, uint16_t scrollCount, uint16_t scrollUp
 
 	kaelTui_pushScroll(&book->rowBuf, scrollCount, scrollUp);
 	//iterator
-	KaelBook_shape *shapePtr = kaelTree_begin(&pagePtr->shape);
-	while(shapePtr){
+	KaelBook_shapeId shapeCount = kaelBook_shapeCount(pagePtr);
+	for(KaelBook_shapeId i=0; i<shapeCount; i++){
+		KaelBook_shape *shapePtr = kaelDeque_get(&pagePtr->shape, i);
 		if( kaelBook_isShapeInRows(shapePtr, rowY0, rowY1) ){
 			//Check what shapes need to be redrawn
-			kaelTree_push(&book->drawQueue, &shapePtr);
+			kaelBook_queueShape(book, i);
 		}
-		kaelTree_next(&pagePtr->shape, (void**)&shapePtr);
 	}
 }
 
@@ -347,7 +395,7 @@ void kaelBook_scrollRows(KaelBook *book, uint16_t scrollCount, uint16_t scrollUp
 */	
 void kaelBook_scrollCols(KaelBook *book, uint16_t scrollCount, uint16_t scrollLeft){
 	KaelBook_page *pagePtr = kaelTree_get(&book->page, book->index);
-	if(kaelTree_empty(&pagePtr->shape)){
+	if(kaelDeque_empty(&pagePtr->shape)){
 		return;
 	}
 
@@ -362,12 +410,12 @@ void kaelBook_scrollCols(KaelBook *book, uint16_t scrollCount, uint16_t scrollLe
 	}
 
 	//iterator
-	KaelBook_shape *shapePtr = kaelTree_begin(&pagePtr->shape);
-	while(shapePtr){
+	KaelBook_shapeId shapeCount = kaelBook_shapeCount(pagePtr);
+	for(KaelBook_shapeId i=0; i<shapeCount; i++){
+		KaelBook_shape *shapePtr = kaelDeque_get(&pagePtr->shape, i);
 		if( kaelBook_isShapeInView(book, shapePtr) ){
 			//Queue every visible shape
-			kaelTree_push(&book->drawQueue, &shapePtr);
+			kaelBook_queueShape(book, i);
 		}
-		kaelTree_next(&pagePtr->shape, (void**)&shapePtr);
 	}
 }
\ No newline at end of file
@@ -10,6 +10,9 @@
 #include "kaelygon/global/kaelMacros.h"
 #include "kaelygon/math/math.h"
 #include "kaelygon/treeMem/tree.h"
+#include "kaelygon/treeMem/typedTree.h"
+#include "kaelygon/treeMem/deque.h"
+#include "kaelygon/mem/mem.h"
 #include "kaelygon/book/tui.h"
 
 #include "krle/krleBase.h"
@@ -37,14 +40,25 @@ typedef enum{
 //but does it outweigh the need to track the strlen?
 typedef struct{
 	uint8_t *string; //data byte string
-	uint8_t ownsString;
+	uint8_t ownsString; //string is freed with the page, allocate it with KAEL_MALLOC or a KaelTree
 	uint16_t pos[2]; //col/row position  (book space)
 	uint16_t size[2];
 	uint8_t drawMode; 
+	uint8_t flags; //KAEL_BOOK_SHAPE_* bits
 }KaelBook_shape;
 
+#define KAEL_BOOK_SHAPE_QUEUED 0b1U //shape is in drawQueue, queueing it again is skipped
+
+//Shape handle, index of the shape in current page
+typedef uint16_t KaelBook_shapeId;
+#define KAEL_BOOK_NO_SHAPE UINT16_MAX
+
+//Typical frame queues fewer than 16 shapes, those stay inline in KaelBook
+#define KAEL_BOOK_QUEUE_INLINE 16
+KAEL_TREE_DEFINE_SMALL(shapeQueue, KaelBook_shapeId, KAEL_BOOK_QUEUE_INLINE)
+
 typedef struct{
-	KaelTree shape; //Vector like dynamic data
+	KaelDeque shape; //Chunked, shape addresses stay valid while the page grows
 }KaelBook_page;
 
 typedef struct{
@@ -54,7 +68,7 @@ typedef struct{
 	uint16_t index; //Page index
 
 	KaelTui_rowBuffer rowBuf; //print row buffer
-	KaelTree drawQueue; //list of shape POINTERS to be printed
+	KaelTree_shapeQueue drawQueue; //current page shapes to be printed, each at most once
 }KaelBook;
 
 
@@ -94,10 +108,13 @@ uint8_t kaelBook_isRowInView(KaelBook *book, KaelBook_shape *shapePtr, uint16_t
 
 uint8_t kaelBook_isAboveShape(KaelBook *book, KaelBook_shape *shapePtr, uint16_t shapeRow);
 uint8_t kaelBook_isBelowShape(KaelBook *book, KaelBook_shape *shapePtr, uint16_t shapeRow);
-KaelBook_shape *kaelBook_getShapeAt(KaelBook *book, uint16_t viewCol, uint16_t viewRow);
 
 
 
-//------ Get shapePtr ------
-KaelBook_shape *kaelBook_getShapeAt(KaelBook *book, uint16_t viewCol, uint16_t viewRow);
+//------ Shape handles ------
+KaelBook_shapeId kaelBook_shapeCount(const KaelBook_page *page);
+KaelBook_shapeId kaelBook_getShapeAt(KaelBook *book, uint16_t viewCol, uint16_t viewRow);
+KaelBook_shape *kaelBook_getShape(KaelBook *book, KaelBook_shapeId id);
+uint8_t kaelBook_queueShape(KaelBook *book, KaelBook_shapeId id);
+void kaelBook_clearQueue(KaelBook *book);
 
@@ -220,8 +220,7 @@ void kaelBook_drawShape(KaelBook *book, KaelBook_shape *shapePtr){
 }
 
 /**
-	@brief print book shape queue
-	TODO: Don't draw duplicates
+	@brief print book shape queue. Queue holds every shape at most once
 */	
 void kaelBook_drawQueue(KaelBook *book){
 	KAEL_ASSERT(book!=NULL);
@@ -230,10 +229,11 @@ void kaelBook_drawQueue(KaelBook *book){
 	kaelTui_pushConstChar(&book->rowBuf, KRLE_STYLE_RESET);
 	
 	//Iterate drawQueue
-	while(!kaelTree_empty(&book->drawQueue)){
-		KaelBook_shape *shapePtr = *(KaelBook_shape **)kaelTree_back(&book->drawQueue);
+	while(!kaelTree_shapeQueue_empty(&book->drawQueue)){
+		KaelBook_shape *shapePtr = kaelBook_getShape(book, *kaelTree_shapeQueue_back(&book->drawQueue));
+		shapePtr->flags &= ~KAEL_BOOK_SHAPE_QUEUED;
 		kaelBook_drawShape(book, shapePtr);
-		kaelTree_pop(&book->drawQueue);
+		kaelTree_shapeQueue_pop(&book->drawQueue);
 	}
 
 	//reset and mov cursor to end
@@ -252,6 +252,9 @@ void kaelBook_switchPage(KaelBook *book, uint16_t index){
 		return;
 	}
 	index = kaelMath_min(index, kaelTree_length(&book->page));
+	if(index != book->index){
+		kaelBook_clearQueue(book); //Queued ids refer to the old page
+	}
 	book->index=index;
 }
 
@@ -260,16 +263,16 @@ void kaelBook_switchPage(KaelBook *book, uint16_t index){
  */
 void kaelBook_queueViewShapes(KaelBook *book){
 	KaelBook_page *pagePtr = kaelTree_get(&book->page, book->index);
-	if(kaelTree_empty(&pagePtr->shape)){
+	if(kaelDeque_empty(&pagePtr->shape)){
 		return;
 	}
 	//iterator
-	KaelBook_shape *shapePtr = kaelTree_begin(&pagePtr->shape);
-	while(shapePtr){
+	KaelBook_shapeId shapeCount = kaelBook_shapeCount(pagePtr);
+	for(KaelBook_shapeId i=0; i<shapeCount; i++){
+		KaelBook_shape *shapePtr = kaelDeque_get(&pagePtr->shape, i);
 		if( kaelBook_isShapeInView(book, shapePtr) ){
-			kaelTree_push(&book->drawQueue, &shapePtr);
+			kaelBook_queueShape(book, i);
 		}
-		kaelTree_next(&pagePtr->shape, (void**)&shapePtr);
 	}
 }
 
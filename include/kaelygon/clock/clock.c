@@ -6,43 +6,173 @@
 
 #include "kaelygon/clock/clock.h"
 
+#define NS_PER_SECOND 1000000000ULL
+
+uint8_t _kaelClock_variant = KAEL_CLOCK_UNSET;
+
+uint64_t _kaelClock_monotonicNs(){
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec*NS_PER_SECOND + now.tv_nsec;
+}
+
+/**
+ * @brief Calibrate rdtsc, fall back to clock_gettime based hybrid variant if TSC isn't usable
+ * 
+ * Called by kaelClock_init, takes up to CLOCK_CALIBRATE_NS. Later calls return the chosen variant
+ * @return KaelClock_variant
+ */
+uint8_t kaelClock_selectVariant(){
+	if(_kaelClock_variant != KAEL_CLOCK_UNSET){
+		return _kaelClock_variant;
+	}
+	_kaelClock_variant = KAEL_CLOCK_HYBRID;
+	#if CLOCK_USING_RDTSC && !CLOCK_USING_HYBRID
+		if( kaelClock_rdtsc_calibrate() == KAEL_SUCCESS ){
+			_kaelClock_variant = KAEL_CLOCK_RDTSC;
+		}
+	#endif
+	return _kaelClock_variant;
+}
+
+/**
+ * @brief Override selected variant, e.g. KAEL_CLOCK_VIRTUAL for tests and offline rendering
+ * 
+ * Call before kaelClock_init. Virtual clock restarts from 0
+ * @return KAEL_SUCCESS, KAEL_ERR_UNSUPPORTED if rdtsc can't be calibrated
+ */
+uint8_t kaelClock_setVariant(uint8_t variant){
+	switch(variant){
+		case KAEL_CLOCK_RDTSC:
+			if( kaelClock_rdtsc_calibrate() != KAEL_SUCCESS ){
+				return KAEL_ERR_UNSUPPORTED;
+			}
+			break;
+		case KAEL_CLOCK_HYBRID:
+			break;
+		case KAEL_CLOCK_VIRTUAL:
+			kaelClock_virtual_setTime(0);
+			break;
+		default:
+			return KAEL_ERR_UNSUPPORTED;
+	}
+	_kaelClock_variant = variant;
+	return KAEL_SUCCESS;
+}
+
+uint8_t kaelClock_getVariant(){
+	return _kaelClock_variant;
+}
+
 /**
  * @brief Fine time clock runs at TARGET_CLOCK_HZ
  * 
  * Rolls over every UINT16_MAX / TARGET_CLOCK_HZ second
  */
 ktime_t kaelClock_time(){
-	#if CLOCK_USING_RDTSC
-		return kaelClock_rdtsc_time();
-	#endif
-	return 0;
+	switch( kaelClock_selectVariant() ){
+		case KAEL_CLOCK_RDTSC:
+			return kaelClock_rdtsc_time();
+		case KAEL_CLOCK_VIRTUAL:
+			return kaelClock_virtual_time();
+		default:
+			return kaelClock_hybrid_time();
+	}
 }
 
 void kaelClock_init(KaelClock *clock){
 	if (NULL_CHECK(clock)) { return; }
 
+	kaelClock_selectVariant();
 	clock->bufferStartTick = kaelClock_time();
 	clock->tickHigh = 0;
 	clock->tickLow = 0;
 
 	clock->tickRate = AUDIO_SAMPLE_RATE/AUDIO_BUFFER_SIZE;
 	clock->ticksPerBuffer = (TARGET_CLOCK_HZ)/clock->tickRate;
+
+	clock->tickTop = 0;
+	clock->refStartNs = _kaelClock_monotonicNs();
+	clock->periodNs = (uint64_t)clock->ticksPerBuffer*NS_PER_SECOND/TARGET_CLOCK_HZ;
+	clock->driftSum = 0;
+	kaelClock_resetStats(clock);
 }
 
 void kaelClock_sleep(ktime_t cycles){
-	#if CLOCK_USING_RDTSC
-		kaelClock_rdtsc_sleep(cycles);
-	#endif
+	switch( kaelClock_selectVariant() ){
+		case KAEL_CLOCK_RDTSC:
+			kaelClock_rdtsc_sleep(cycles);
+			break;
+		case KAEL_CLOCK_VIRTUAL:
+			kaelClock_virtual_sleep(cycles);
+			break;
+		default:
+			kaelClock_hybrid_sleep(cycles);
+			break;
+	}
+}
+
+int32_t _kaelClock_clamp(int32_t value, int32_t low, int32_t high){
+	return value < low ? low : (value > high ? high : value);
+}
+
+/**
+ * @brief PLL against CLOCK_MONOTONIC. Returns ticks to take off the coming wait, negative to wait longer
+ * 
+ * Scaled TSC rate is off by rounding and overruns push deadlines late. Without correction both accumulate over days
+ */
+int32_t _kaelClock_driftCorrection(KaelClock *clock, ktime_t waitTime){
+	uint64_t idealNs = clock->refStartNs + kaelClock_getTick64(clock)*clock->periodNs;
+	uint64_t wakeNs = _kaelClock_monotonicNs() + (uint64_t)waitTime*NS_PER_SECOND/TARGET_CLOCK_HZ;
+	int64_t phaseNs = (int64_t)(wakeNs - idealNs); //positive = behind
+
+	if(phaseNs > (int64_t)clock->periodNs*CLOCK_SLIP_BUFFERS || phaseNs < -(int64_t)clock->periodNs*CLOCK_SLIP_BUFFERS){
+		//Long stall, catching up would rush many buffers. Continue from here
+		clock->refStartNs += phaseNs;
+		clock->driftSum = 0;
+		clock->stats.slips++;
+		phaseNs = 0;
+	}
+	clock->stats.phaseErrorNs = (int32_t)phaseNs;
+
+	int32_t phaseTicks = (int32_t)(phaseNs*TARGET_CLOCK_HZ/(int64_t)NS_PER_SECOND);
+	//Integrate only small errors. Catching up after a stall would wind the sum up and overshoot
+	if(phaseTicks*CLOCK_DRIFT_P < clock->ticksPerBuffer && -phaseTicks*CLOCK_DRIFT_P < clock->ticksPerBuffer){
+		int32_t sumLimit = (int32_t)clock->ticksPerBuffer*CLOCK_DRIFT_I;
+		clock->driftSum = _kaelClock_clamp(clock->driftSum + phaseTicks, -sumLimit, sumLimit);
+	}
+
+	int32_t correction = phaseTicks/CLOCK_DRIFT_P + clock->driftSum/CLOCK_DRIFT_I;
+	int32_t limit = clock->ticksPerBuffer/2;
+	return _kaelClock_clamp(correction, -limit, limit);
+}
+
+/**
+ * @brief Record how late this tick woke up compared to its ideal monotonic time
+ */
+void _kaelClock_measureWake(KaelClock *clock){
+	uint64_t idealNs = clock->refStartNs + kaelClock_getTick64(clock)*clock->periodNs;
+	int32_t latenessNs = (int32_t)(int64_t)(_kaelClock_monotonicNs() - idealNs);
+
+	//Smoothed like RTP interarrival jitter, J += (|D|-J)/16
+	int32_t delta = latenessNs - clock->stats.lastLatenessNs;
+	uint32_t absDelta = delta<0 ? -delta : delta;
+	clock->stats.jitterNs += ((int32_t)absDelta - (int32_t)clock->stats.jitterNs)/16;
+
+	clock->stats.lastLatenessNs = latenessNs;
+	clock->stats.maxLatenessNs = latenessNs > clock->stats.maxLatenessNs ? latenessNs : clock->stats.maxLatenessNs;
 }
 
 /**
  * @brief Increment tick and sleep remaining time
  * 
+ * Real clocks are steered to CLOCK_MONOTONIC so tick n wakes at n buffers since kaelClock_init
  * Call last in loop
  */
 ktime_t kaelClock_sync(KaelClock *clock){
 	clock->tickLow++;
 	clock->tickHigh += clock->tickLow==0 ;
+	clock->tickTop += (clock->tickLow|clock->tickHigh)==0 ;
 
 	ktime_t timeNow = kaelClock_time();
 	ktime_t elapsed=0;
@@ -56,8 +186,20 @@ ktime_t kaelClock_sync(KaelClock *clock){
 
 	uint8_t timerOverrun = elapsed > clock->ticksPerBuffer;
    ktime_t waitTime = timerOverrun ? 0 : clock->ticksPerBuffer - elapsed; //prevent underflow
+	clock->stats.overruns += timerOverrun;
+
+	uint8_t isVirtual = kaelClock_getVariant()==KAEL_CLOCK_VIRTUAL;
+	if(!isVirtual){
+		int32_t correction = _kaelClock_driftCorrection(clock, waitTime);
+		waitTime = _kaelClock_clamp((int32_t)waitTime - correction, 0, (int32_t)clock->ticksPerBuffer*2);
+	}
+
    clock->bufferStartTick = timeNow+waitTime; //New tick starts after the wait
 	kaelClock_sleep(waitTime);
+
+	if(!isVirtual){
+		_kaelClock_measureWake(clock);
+	}
 	return 0;
 }
 
@@ -68,3 +210,20 @@ ktime_t kaelClock_getTick(const KaelClock *clock){
 ktime_t kaelClock_getTickHigh(const KaelClock *clock){
 	return clock->tickHigh;
 }
+
+/**
+ * @brief Ticks since kaelClock_init, doesn't wrap in practice
+ */
+uint64_t kaelClock_getTick64(const KaelClock *clock){
+	return ((uint64_t)clock->tickTop<<32) | ((uint64_t)clock->tickHigh<<16) | clock->tickLow;
+}
+
+void kaelClock_getStats(const KaelClock *clock, KaelClock_stats *stats){
+	if (NULL_CHECK(clock) || NULL_CHECK(stats)) { return; }
+	*stats = clock->stats;
+}
+
+void kaelClock_resetStats(KaelClock *clock){
+	if (NULL_CHECK(clock)) { return; }
+	clock->stats = (KaelClock_stats){0};
+}
@@ -16,14 +16,28 @@
 #include "kaelygon/global/kaelMacros.h"
 #include "kaelygon/clock/clockShared.h"
 
-//Use 
-#if CLOCK_USING_RDTSC
-	#include "kaelygon/clock/variant/rdtscClock.h"
-#endif
+//Variant is chosen at runtime, rdtsc if TSC is invariant and calibrates, otherwise hybrid
+#include "kaelygon/clock/variant/rdtscClock.h"
+#include "kaelygon/clock/variant/hybridClock.h"
+#include "kaelygon/clock/variant/virtualClock.h"
+
+typedef enum{
+	KAEL_CLOCK_UNSET = 0,
+	KAEL_CLOCK_RDTSC,
+	KAEL_CLOCK_HYBRID,
+	KAEL_CLOCK_VIRTUAL, //Only by kaelClock_setVariant
+}KaelClock_variant;
+
+uint8_t kaelClock_selectVariant();
+uint8_t kaelClock_setVariant(uint8_t variant);
+uint8_t kaelClock_getVariant();
 
 ktime_t kaelClock_time();
 void kaelClock_sleep(ktime_t cycles);
 void kaelClock_init(KaelClock *clock);
 ktime_t kaelClock_sync(KaelClock *clock);
 ktime_t kaelClock_getTick(const KaelClock *clock);
-ktime_t kaelClock_getTickHigh(const KaelClock *clock);
\ No newline at end of file
+ktime_t kaelClock_getTickHigh(const KaelClock *clock);
+uint64_t kaelClock_getTick64(const KaelClock *clock);
+void kaelClock_getStats(const KaelClock *clock, KaelClock_stats *stats);
+void kaelClock_resetStats(KaelClock *clock);
\ No newline at end of file
@@ -16,6 +16,7 @@
 //------ CLOCK SYNC DEFINES ------
 
 
+//TSC rate until kaelClock_rdtsc_calibrate measures the real one
 #define CLOCK_SPEED_HZ 3704954300U //AMD Ryzen 5900x 3.7GHz
 
 //Audio will be 32768hz so that will be the default clock
@@ -35,8 +36,8 @@
 
 //------ RDTSC ------
  
-//RDTSC will be the fallback as afaik it's the most readibly available 
-//low lever timer that doesn't require root
+//RDTSC is preferred when TSC is invariant, it's the most readibly available 
+//low lever timer that doesn't require root. Otherwise hybrid is selected at runtime
 #ifndef CLOCK_USING_RDTSC
 	#if CLOCK_TARGET_RATIO != 1
 		//If clock has to be scaled
@@ -46,15 +47,49 @@
 
 
 
+//------ HYBRID ------
+
+//clock_nanosleep until CLOCK_HYBRID_SPIN_NS before deadline, then spin. Doesn't pin a core while idle
+//Selected when TSC isn't usable, 1 = always use it
+#ifndef CLOCK_USING_HYBRID
+	#define CLOCK_USING_HYBRID 0
+#endif
+
+//Spin tail covers typical scheduler wake up latency
+#define CLOCK_HYBRID_SPIN_NS 50000U
+
+
+
 //------ SHARED TYPES ------
 
 typedef uint16_t ktime_t;
 #define KTIME_MAX UINT16_MAX
 
+//Drift correction. Phase error is corrected by 1/CLOCK_DRIFT_P per tick, its sum by 1/CLOCK_DRIFT_I
+#define CLOCK_DRIFT_P 8
+#define CLOCK_DRIFT_I 256
+//Further behind than this many buffers and the clock rebases instead of catching up
+#define CLOCK_SLIP_BUFFERS 8
+
+typedef struct{
+	int32_t lastLatenessNs; // Wake up time minus ideal tick time
+	int32_t maxLatenessNs;
+	uint32_t jitterNs; // Smoothed change of lateness between ticks
+	int32_t phaseErrorNs; // Drift from monotonic clock before last correction
+	uint32_t overruns; // Ticks that ran past their deadline
+	uint32_t slips; // Times the clock rebased after a long stall
+}KaelClock_stats;
+
 typedef struct{
 	ktime_t bufferStartTick; // Tick count at beginning of current cycle
 	uint16_t tickHigh; // Long time
 	uint16_t tickLow; // Short time
 	uint16_t tickRate; // Ticks in second. Buffer fill rate per second
 	ktime_t ticksPerBuffer; // Ticks between buffer
+
+	uint32_t tickTop; // Wraps of tickHigh, forms 64-bit tick count with tickHigh and tickLow
+	uint64_t refStartNs; // CLOCK_MONOTONIC time of tick 0
+	uint32_t periodNs; // Buffer length
+	int32_t driftSum; // Accumulated phase error in ticks
+	KaelClock_stats stats;
 }KaelClock;
\ No newline at end of file
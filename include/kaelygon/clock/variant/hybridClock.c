@@ -0,0 +1,48 @@
+/**
+ * @file hybridClock.c
+ * 
+ * @brief Implementation, clock using CLOCK_MONOTONIC with sleep and short spin tail
+ * 
+ * clock_nanosleep wakes up late by scheduler latency, so it only sleeps until CLOCK_HYBRID_SPIN_NS before the deadline.
+ * The remaining time is spun like rdtsc variant. Idle loop uses a few percent of a core instead of all of it
+ */
+
+#include "kaelygon/clock/variant/hybridClock.h"
+
+#define NS_PER_SECOND 1000000000ULL
+
+typedef unsigned long long hybrid_ns_t;
+
+hybrid_ns_t _kaelClock_hybrid_nowNs(){
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (hybrid_ns_t)now.tv_sec*NS_PER_SECOND + now.tv_nsec;
+}
+
+void kaelClock_hybrid_sleep(ktime_t sleepTime) {
+	hybrid_ns_t startNs = _kaelClock_hybrid_nowNs();
+	hybrid_ns_t deadlineNs = startNs + (hybrid_ns_t)sleepTime*NS_PER_SECOND/TARGET_CLOCK_HZ;
+
+	if(deadlineNs - startNs > CLOCK_HYBRID_SPIN_NS){
+		hybrid_ns_t wakeNs = deadlineNs - CLOCK_HYBRID_SPIN_NS;
+		struct timespec wake = {
+			.tv_sec  = wakeNs / NS_PER_SECOND,
+			.tv_nsec = wakeNs % NS_PER_SECOND
+		};
+		while( clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, NULL) != 0 ){} //restart if interrupted by signal
+	}
+
+	while( _kaelClock_hybrid_nowNs() < deadlineNs ){
+		__builtin_ia32_pause();
+	}
+}
+
+/**
+ * @brief Seconds and nanoseconds are scaled separately so the product never overflows
+ */
+ktime_t kaelClock_hybrid_time(){
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	ktime_t time = (ktime_t)( (hybrid_ns_t)now.tv_sec*TARGET_CLOCK_HZ + (hybrid_ns_t)now.tv_nsec*TARGET_CLOCK_HZ/NS_PER_SECOND );
+	return time;
+}
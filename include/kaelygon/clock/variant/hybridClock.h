@@ -0,0 +1,16 @@
+/**
+ * @file hybridClock.h
+ * 
+ * @brief Header, clock using CLOCK_MONOTONIC with sleep and short spin tail
+ * 
+ */
+#pragma once
+
+#include <time.h>
+#include <x86intrin.h> 
+
+//Types and definitions that all the implementation variants use
+#include "kaelygon/clock/clockShared.h"
+
+void kaelClock_hybrid_sleep(ktime_t sleepTime);
+ktime_t kaelClock_hybrid_time();
@@ -3,6 +3,7 @@
  * 
  * @brief Implementation, clock using rdtsc
  * 
+ * TSC rate is calibrated at startup against CLOCK_MONOTONIC_RAW. CLOCK_TARGET_RATIO is used only until then
  */
 
 #include "kaelygon/clock/variant/rdtscClock.h"
@@ -10,8 +11,82 @@
 // Read date time stamp clock return type
 typedef unsigned long long rdtsc_t;
 
+#define NS_PER_SECOND 1000000000ULL
+
+//TSC cycles per target clock tick
+rdtsc_t _kaelClock_rdtscRatio = CLOCK_TARGET_RATIO;
+
+
+
+//------ Calibration ------
+
+/**
+ * @brief CPUID 0x80000007 EDX bit 8. Invariant TSC runs at constant rate in every P-, C- and T-state
+ * @return 1 if TSC is invariant
+ */
+uint8_t kaelClock_rdtsc_isInvariant(){
+	unsigned int eax, ebx, ecx, edx;
+	if( !__get_cpuid(0x80000000U, &eax, &ebx, &ecx, &edx) || eax < 0x80000007U ){
+		return 0;
+	}
+	__get_cpuid(0x80000007U, &eax, &ebx, &ecx, &edx);
+	return (edx >> 8) & 1U;
+}
+
+/**
+ * @brief Read CLOCK_MONOTONIC_RAW and TSC at the same moment. TSC is the midpoint of reads around clock_gettime
+ */
+rdtsc_t _kaelClock_rdtsc_sampleNs(rdtsc_t *tsc){
+	struct timespec now;
+	rdtsc_t before = __rdtsc();
+	clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+	rdtsc_t after = __rdtsc();
+	*tsc = before + (after-before)/2;
+	return (rdtsc_t)now.tv_sec*NS_PER_SECOND + now.tv_nsec;
+}
+
+/**
+ * @brief Measure TSC rate over CLOCK_CALIBRATE_NS and set tick ratio
+ * @return KAEL_SUCCESS, KAEL_ERR_UNSUPPORTED if TSC isn't invariant or measurement is implausible
+ */
+uint8_t kaelClock_rdtsc_calibrate(){
+	if(!kaelClock_rdtsc_isInvariant()){
+		return KAEL_ERR_UNSUPPORTED;
+	}
+
+	rdtsc_t tscStart, tscEnd;
+	rdtsc_t nsStart = _kaelClock_rdtsc_sampleNs(&tscStart);
+
+	struct timespec wait = { .tv_sec = 0, .tv_nsec = CLOCK_CALIBRATE_NS };
+	nanosleep(&wait, NULL);
+
+	rdtsc_t nsEnd = _kaelClock_rdtsc_sampleNs(&tscEnd);
+	rdtsc_t elapsedNs = nsEnd - nsStart;
+	if(elapsedNs == 0 || tscEnd <= tscStart){
+		return KAEL_ERR_UNSUPPORTED;
+	}
+
+	//Cycles per tick = cycles / (elapsedNs * TARGET_CLOCK_HZ / NS_PER_SECOND), rounded
+	rdtsc_t elapsedTicks = elapsedNs * TARGET_CLOCK_HZ;
+	rdtsc_t ratio = ( (tscEnd-tscStart) * NS_PER_SECOND + elapsedTicks/2 ) / elapsedTicks;
+	if(ratio < 2){
+		return KAEL_ERR_UNSUPPORTED; //TSC slower than target clock can't be scaled down
+	}
+
+	_kaelClock_rdtscRatio = ratio;
+	return KAEL_SUCCESS;
+}
+
+rdtsc_t kaelClock_rdtsc_getRatio(){
+	return _kaelClock_rdtscRatio;
+}
+
+
+
+//------ Time ------
+
 void kaelClock_rdtsc_sleep(ktime_t sleepTime) {
-	rdtsc_t scaledSleep = (rdtsc_t)sleepTime*(rdtsc_t)CLOCK_TARGET_RATIO;
+	rdtsc_t scaledSleep = (rdtsc_t)sleepTime*_kaelClock_rdtscRatio;
 	rdtsc_t startCycle = __rdtsc();
 	
 	do{
@@ -20,6 +95,6 @@ void kaelClock_rdtsc_sleep(ktime_t sleepTime) {
 }
 
 ktime_t kaelClock_rdtsc_time(){
-	ktime_t time = __rdtsc()/(rdtsc_t)CLOCK_TARGET_RATIO;
+	ktime_t time = __rdtsc()/_kaelClock_rdtscRatio;
 	return time;
 }
@@ -7,10 +7,19 @@
 #pragma once
 
 #include <unistd.h>
+#include <time.h>
+#include <cpuid.h>
 #include <x86intrin.h> 
 
 //Types and definitions that all the implementation variants use
 #include "kaelygon/clock/clockShared.h"
 
+//Length of TSC measurement against CLOCK_MONOTONIC_RAW. Whole calibration stays under 50 ms
+#define CLOCK_CALIBRATE_NS 20000000ULL
+
+uint8_t kaelClock_rdtsc_isInvariant();
+uint8_t kaelClock_rdtsc_calibrate();
+unsigned long long kaelClock_rdtsc_getRatio();
+
 void kaelClock_rdtsc_sleep(ktime_t sleepTime);
-ktime_t kaelClock_rdtsc_time();
\ No newline at end of file
+ktime_t kaelClock_rdtsc_time();
@@ -0,0 +1,24 @@
+/**
+ * @file virtualClock.c
+ * 
+ * @brief Implementation, deterministic clock that advances only when slept
+ * 
+ * Work between syncs takes zero virtual time, so kaelClock_sync always sleeps a full buffer and returns immediately.
+ * Tests and offline renders get the same tick sequence as real time without waiting for it
+ */
+
+#include "kaelygon/clock/variant/virtualClock.h"
+
+ktime_t _kaelClock_virtualTime = 0;
+
+void kaelClock_virtual_sleep(ktime_t sleepTime) {
+	_kaelClock_virtualTime += sleepTime;
+}
+
+ktime_t kaelClock_virtual_time(){
+	return _kaelClock_virtualTime;
+}
+
+void kaelClock_virtual_setTime(ktime_t time){
+	_kaelClock_virtualTime = time;
+}
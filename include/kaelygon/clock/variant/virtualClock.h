@@ -0,0 +1,14 @@
+/**
+ * @file virtualClock.h
+ * 
+ * @brief Header, deterministic clock that advances only when slept
+ * 
+ */
+#pragma once
+
+//Types and definitions that all the implementation variants use
+#include "kaelygon/clock/clockShared.h"
+
+void kaelClock_virtual_sleep(ktime_t sleepTime);
+ktime_t kaelClock_virtual_time();
+void kaelClock_virtual_setTime(ktime_t time);
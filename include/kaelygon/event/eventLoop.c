@@ -0,0 +1,259 @@
+/**
+ * @file eventLoop.c
+ *
+ * @brief Implementation, epoll event loop over clock ticks, stdin, terminal resize and audio backend descriptors
+ *
+ * Clock ticks come from a timerfd with absolute periodic expiry, SIGWINCH from a signalfd.
+ * Every source is a slot in loop->source, epoll user data is the slot index
+ */
+
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/signalfd.h>
+
+#include "kaelygon/event/eventLoop.h"
+#include "kaelygon/mem/mem.h"
+
+#define KAEL_EVENT_WAIT_MAX 8
+#define NS_PER_SECOND 1000000000ULL
+
+
+
+
+//------ Alloc / Free ------
+
+uint8_t kaelEvent_alloc(KaelEvent_loop *loop){
+	if(NULL_CHECK(loop)){return KAEL_ERR_NULL;}
+	*loop = (KaelEvent_loop){0};
+	loop->timerFd = -1;
+	loop->signalFd = -1;
+
+	loop->epollFd = epoll_create1(EPOLL_CLOEXEC);
+	if(loop->epollFd < 0){
+		KAEL_ERROR_NOTE("kaelEvent_alloc epoll_create1 failed\n");
+		return KAEL_ERR_ALLOC;
+	}
+	return KAEL_SUCCESS;
+}
+
+/**
+ * @brief Close descriptors the loop created. Caller owned descriptors stay open
+ */
+void kaelEvent_free(KaelEvent_loop *loop){
+	if(NULL_CHECK(loop)){return;}
+	if(loop->timerFd >= 0){
+		close(loop->timerFd);
+	}
+	if(loop->signalFd >= 0){
+		close(loop->signalFd);
+		pthread_sigmask(SIG_SETMASK, &loop->oldMask, NULL);
+	}
+	if(loop->epollFd >= 0){
+		close(loop->epollFd);
+	}
+	*loop = (KaelEvent_loop){0};
+	loop->epollFd = -1;
+	loop->timerFd = -1;
+	loop->signalFd = -1;
+}
+
+
+
+
+//------ Sources ------
+
+uint8_t _kaelEvent_addSource(KaelEvent_loop *loop, const KaelEvent_source *source, uint32_t events){
+	if(loop->sourceCount >= KAEL_EVENT_SOURCES_MAX){
+		return KAEL_ERR_FULL;
+	}
+
+	struct epoll_event ev = { .events = events, .data.u32 = loop->sourceCount };
+	if( epoll_ctl(loop->epollFd, EPOLL_CTL_ADD, source->fd, &ev) != 0 ){
+		KAEL_ERROR_NOTE("kaelEvent epoll_ctl failed\n");
+		return KAEL_ERR_ALLOC;
+	}
+
+	loop->source[loop->sourceCount] = *source;
+	loop->sourceCount++;
+	return KAEL_SUCCESS;
+}
+
+/**
+ * @brief Call func when fd has any of events (EPOLLIN, EPOLLOUT...). fd is owned by caller
+ * @return KAEL_SUCCESS, KAEL_ERR_FULL if all KAEL_EVENT_SOURCES_MAX are taken
+ */
+uint8_t kaelEvent_addFd(KaelEvent_loop *loop, int fd, uint32_t events, KaelEvent_fdFunc func, void *state){
+	if(NULL_CHECK(loop) || func==NULL){return KAEL_ERR_NULL;}
+	KaelEvent_source source = { .fd = fd, .type = KAEL_EVENT_FD, .state = state, .fdFunc = func };
+	return _kaelEvent_addSource(loop, &source, events);
+}
+
+/**
+ * @brief Watch poll descriptors of an audio backend, e.g. from snd_pcm_poll_descriptors
+ *
+ * POLLIN/POLLOUT/POLLERR have the same values as their EPOLL counterparts on Linux
+ */
+uint8_t kaelEvent_addPollFds(KaelEvent_loop *loop, const struct pollfd *fds, uint8_t count, KaelEvent_fdFunc func, void *state){
+	if(NULL_CHECK(loop) || NULL_CHECK(fds)){return KAEL_ERR_NULL;}
+	for(uint8_t i=0; i<count; i++){
+		uint8_t code = kaelEvent_addFd(loop, fds[i].fd, (uint16_t)fds[i].events, func, state);
+		if(code != KAEL_SUCCESS){
+			return code;
+		}
+	}
+	return KAEL_SUCCESS;
+}
+
+/**
+ * @brief Call func when stdin is readable, e.g. to run kaelTui_getKeyPressStr only when there is a key
+ */
+uint8_t kaelEvent_watchStdin(KaelEvent_loop *loop, KaelEvent_fdFunc func, void *state){
+	return kaelEvent_addFd(loop, STDIN_FILENO, EPOLLIN, func, state);
+}
+
+/**
+ * @brief Start periodic clock tick. Expiry times are absolute, so late callbacks don't shift later ticks
+ * @param periodNs e.g. buffer length AUDIO_BUFFER_SIZE/AUDIO_SAMPLE_RATE in ns
+ */
+uint8_t kaelEvent_setTimer(KaelEvent_loop *loop, uint32_t periodNs, KaelEvent_tickFunc func, void *state){
+	if(NULL_CHECK(loop) || func==NULL){return KAEL_ERR_NULL;}
+	if(loop->timerFd >= 0){
+		return KAEL_ERR_FULL; //one clock per loop
+	}
+
+	int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	if(fd < 0){
+		return KAEL_ERR_ALLOC;
+	}
+
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	struct timespec period = { .tv_sec = periodNs / NS_PER_SECOND, .tv_nsec = periodNs % NS_PER_SECOND };
+	uint64_t firstNs = (uint64_t)now.tv_nsec + periodNs;
+	struct itimerspec spec = {
+		.it_interval = period,
+		.it_value = { .tv_sec = now.tv_sec + firstNs/NS_PER_SECOND, .tv_nsec = firstNs%NS_PER_SECOND },
+	};
+	if( timerfd_settime(fd, TFD_TIMER_ABSTIME, &spec, NULL) != 0 ){
+		close(fd);
+		return KAEL_ERR_ALLOC;
+	}
+
+	KaelEvent_source source = { .fd = fd, .type = KAEL_EVENT_TIMER, .state = state, .tickFunc = func };
+	uint8_t code = _kaelEvent_addSource(loop, &source, EPOLLIN);
+	if(code != KAEL_SUCCESS){
+		close(fd);
+		return code;
+	}
+	loop->timerFd = fd;
+	return KAEL_SUCCESS;
+}
+
+/**
+ * @brief Deliver SIGWINCH through signalfd. The signal is blocked for the calling thread until kaelEvent_free
+ *
+ * Call before creating other threads so they inherit the blocked mask
+ */
+uint8_t kaelEvent_watchResize(KaelEvent_loop *loop, KaelEvent_resizeFunc func, void *state){
+	if(NULL_CHECK(loop) || func==NULL){return KAEL_ERR_NULL;}
+	if(loop->signalFd >= 0){
+		return KAEL_ERR_FULL;
+	}
+
+	sigset_t mask;
+	sigemptyset(&mask);
+	sigaddset(&mask, SIGWINCH);
+	pthread_sigmask(SIG_BLOCK, &mask, &loop->oldMask);
+
+	int fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+	if(fd < 0){
+		pthread_sigmask(SIG_SETMASK, &loop->oldMask, NULL);
+		return KAEL_ERR_ALLOC;
+	}
+
+	KaelEvent_source source = { .fd = fd, .type = KAEL_EVENT_RESIZE, .state = state, .resizeFunc = func };
+	uint8_t code = _kaelEvent_addSource(loop, &source, EPOLLIN);
+	if(code != KAEL_SUCCESS){
+		close(fd);
+		pthread_sigmask(SIG_SETMASK, &loop->oldMask, NULL);
+		return code;
+	}
+	loop->signalFd = fd;
+	return KAEL_SUCCESS;
+}
+
+
+
+
+//------ Running ------
+
+void _kaelEvent_dispatch(KaelEvent_source *source, uint32_t events){
+	switch(source->type){
+		case KAEL_EVENT_TIMER:{
+			uint64_t ticks = 0;
+			if( read(source->fd, &ticks, sizeof(ticks)) == sizeof(ticks) ){
+				source->tickFunc(source->state, ticks);
+			}
+			break;
+		}
+		case KAEL_EVENT_RESIZE:{
+			struct signalfd_siginfo info;
+			uint8_t resized = 0;
+			while( read(source->fd, &info, sizeof(info)) == sizeof(info) ){
+				resized = 1; //coalesce queued resizes
+			}
+			if(resized){
+				source->resizeFunc(source->state);
+			}
+			break;
+		}
+		default:
+			source->fdFunc(source->state, source->fd, events);
+			break;
+	}
+}
+
+/**
+ * @brief Wait for events and dispatch them
+ *
+ * @param timeoutMs -1 waits forever, 0 only checks
+ * @return number of dispatched events, 0 on timeout or signal
+ */
+uint8_t kaelEvent_runOnce(KaelEvent_loop *loop, int timeoutMs){
+	if(NULL_CHECK(loop)){return 0;}
+
+	struct epoll_event ev[KAEL_EVENT_WAIT_MAX];
+	int count = epoll_wait(loop->epollFd, ev, KAEL_EVENT_WAIT_MAX, timeoutMs);
+	if(count <= 0){
+		return 0; //EINTR counts as empty wake up
+	}
+
+	for(int i=0; i<count; i++){
+		uint32_t index = ev[i].data.u32;
+		if(index < loop->sourceCount){
+			_kaelEvent_dispatch(&loop->source[index], ev[i].events);
+		}
+	}
+	return count;
+}
+
+/**
+ * @brief Dispatch events until a callback calls kaelEvent_stop
+ *
+ * Callbacks run in the hot loop, reallocs they make are counted by kaelMem as hot
+ */
+void kaelEvent_run(KaelEvent_loop *loop){
+	if(NULL_CHECK(loop)){return;}
+	loop->quit = 0;
+	kaelMem_setHot(1);
+	while(!loop->quit){
+		kaelEvent_runOnce(loop, -1);
+	}
+	kaelMem_setHot(0);
+}
+
+void kaelEvent_stop(KaelEvent_loop *loop){
+	if(NULL_CHECK(loop)){return;}
+	loop->quit = 1;
+}
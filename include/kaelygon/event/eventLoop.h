@@ -0,0 +1,69 @@
+/**
+ * @file eventLoop.h
+ *
+ * @brief Header, epoll event loop over clock ticks, stdin, terminal resize and audio backend descriptors
+ *
+ * The process sleeps in epoll_wait until something happens, instead of polling stdin and spinning between ticks
+ */
+#pragma once
+
+#include <stdint.h>
+#include <signal.h>
+#include <poll.h>
+
+#include "kaelygon/global/kaelMacros.h"
+
+#define KAEL_EVENT_SOURCES_MAX 16U
+
+//Descriptor callback, events is EPOLLIN/EPOLLOUT/... mask
+typedef void (*KaelEvent_fdFunc)(void *state, int fd, uint32_t events);
+
+//Timer callback, ticks is expirations since last call. More than 1 means the loop was late
+typedef void (*KaelEvent_tickFunc)(void *state, uint64_t ticks);
+
+//Terminal resize callback
+typedef void (*KaelEvent_resizeFunc)(void *state);
+
+typedef enum{
+	KAEL_EVENT_FD = 0,
+	KAEL_EVENT_TIMER,
+	KAEL_EVENT_RESIZE,
+}KaelEvent_sourceType;
+
+typedef struct{
+	int fd;
+	uint8_t type; //KaelEvent_sourceType
+	void *state; //owned by caller
+	union{
+		KaelEvent_fdFunc fdFunc;
+		KaelEvent_tickFunc tickFunc;
+		KaelEvent_resizeFunc resizeFunc;
+	};
+}KaelEvent_source;
+
+typedef struct{
+	int epollFd;
+	int timerFd; //-1 if no timer
+	int signalFd; //-1 if resize isn't watched
+	sigset_t oldMask; //restored when signalFd is closed
+
+	KaelEvent_source source[KAEL_EVENT_SOURCES_MAX];
+	uint8_t sourceCount;
+	uint8_t quit;
+}KaelEvent_loop;
+
+//------ Alloc / Free ------
+uint8_t kaelEvent_alloc(KaelEvent_loop *loop);
+void kaelEvent_free(KaelEvent_loop *loop);
+
+//------ Sources ------
+uint8_t kaelEvent_addFd(KaelEvent_loop *loop, int fd, uint32_t events, KaelEvent_fdFunc func, void *state);
+uint8_t kaelEvent_addPollFds(KaelEvent_loop *loop, const struct pollfd *fds, uint8_t count, KaelEvent_fdFunc func, void *state);
+uint8_t kaelEvent_watchStdin(KaelEvent_loop *loop, KaelEvent_fdFunc func, void *state);
+uint8_t kaelEvent_setTimer(KaelEvent_loop *loop, uint32_t periodNs, KaelEvent_tickFunc func, void *state);
+uint8_t kaelEvent_watchResize(KaelEvent_loop *loop, KaelEvent_resizeFunc func, void *state);
+
+//------ Running ------
+uint8_t kaelEvent_runOnce(KaelEvent_loop *loop, int timeoutMs);
+void kaelEvent_run(KaelEvent_loop *loop);
+void kaelEvent_stop(KaelEvent_loop *loop);
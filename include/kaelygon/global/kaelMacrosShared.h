@@ -18,5 +18,8 @@ typedef enum {
 	KAEL_ERR_FULL			= 131U,
 
 	//KaelStr
-	KAEL_ERR_ALLOC			= 130U
+	KAEL_ERR_ALLOC			= 130U,
+
+	//KaelClock
+	KAEL_ERR_UNSUPPORTED	= 132U
 }Kael_infoCode;
\ No newline at end of file
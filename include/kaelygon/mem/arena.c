@@ -0,0 +1,161 @@
+/**
+ * @file arena.c
+ *
+ * @brief Implementation, bump arena for short lived allocations
+ *
+ * Offsets are relative to base and padded so the returned address is KAEL_ARENA_ALIGN aligned,
+ * even if the caller provided buffer isn't
+ */
+
+#include "kaelygon/mem/arena.h"
+#include "kaelygon/mem/mem.h"
+
+
+
+
+//------ Alloc / Free ------
+
+/**
+ * @brief Initialize arena of size bytes
+ *
+ * @note Optionally provide *buffer that points to at least size bytes. Otherwise the buffer is allocated to heap once
+ * @return Kael_infoCode
+ */
+uint8_t kaelArena_alloc(KaelArena *arena, uint32_t size, uint8_t *buffer){
+	if(NULL_CHECK(arena)){return KAEL_ERR_NULL;}
+	*arena = (KaelArena){0};
+	arena->size = size;
+	arena->last = KAEL_ARENA_NO_LAST;
+
+	if(buffer==NULL){
+		arena->base = KAEL_MALLOC(KAEL_MEM_OTHER, size);
+		if(NULL_CHECK(arena->base)){return KAEL_ERR_ALLOC;}
+		arena->ownsBuffer = 1;
+	}else{
+		arena->base = buffer;
+	}
+	return KAEL_SUCCESS;
+}
+
+void kaelArena_free(KaelArena *arena){
+	if(NULL_CHECK(arena)){return;}
+	if(arena->ownsBuffer){
+		KAEL_FREE(arena->base);
+	}
+	*arena = (KaelArena){0};
+}
+
+
+
+
+//------ Allocate ------
+
+/**
+ * @brief Bump allocate bytes
+ * @return Aligned address or NULL if arena is full
+ */
+void *kaelArena_push(KaelArena *arena, uint32_t bytes){
+	if(NULL_CHECK(arena)){return NULL;}
+
+	uintptr_t address = (uintptr_t)(arena->base + arena->top);
+	uint32_t pad = (uint32_t)(-address & (KAEL_ARENA_ALIGN-1));
+	uint32_t remaining = arena->size - arena->top;
+	if(pad > remaining || bytes > remaining - pad){
+		return NULL;
+	}
+
+	arena->last = arena->top + pad;
+	arena->top = arena->last + bytes;
+	arena->highWater = arena->top > arena->highWater ? arena->top : arena->highWater;
+	return arena->base + arena->last;
+}
+
+/**
+ * @brief Bump allocate zeroed bytes
+ * @return Aligned address or NULL if arena is full
+ */
+void *kaelArena_pushZero(KaelArena *arena, uint32_t bytes){
+	void *ptr = kaelArena_push(arena, bytes);
+	if(ptr!=NULL){
+		memset(ptr, 0, bytes);
+	}
+	return ptr;
+}
+
+/**
+ * @brief realloc() for arena memory. Latest allocation grows or shrinks in place, older ones are copied to a new allocation
+ *
+ * Old copy is released only by rollback or reset
+ * @return New address or NULL if arena is full, ptr stays valid on fail
+ */
+void *kaelArena_resize(KaelArena *arena, void *ptr, uint32_t oldBytes, uint32_t newBytes){
+	if(NULL_CHECK(arena)){return NULL;}
+	if(ptr==NULL){
+		return kaelArena_push(arena, newBytes);
+	}
+
+	if(arena->last != KAEL_ARENA_NO_LAST && (uint8_t *)ptr == arena->base + arena->last){
+		if(newBytes > arena->size - arena->last){
+			return NULL;
+		}
+		arena->top = arena->last + newBytes;
+		arena->highWater = arena->top > arena->highWater ? arena->top : arena->highWater;
+		return ptr;
+	}
+
+	if(newBytes <= oldBytes){
+		return ptr;
+	}
+
+	void *newPtr = kaelArena_push(arena, newBytes);
+	if(newPtr==NULL){
+		return NULL;
+	}
+	memcpy(newPtr, ptr, oldBytes);
+	return newPtr;
+}
+
+
+
+
+//------ Release ------
+
+/**
+ * @brief Remember current top. Everything allocated after it can be released with kaelArena_rollback
+ */
+KaelArena_mark kaelArena_mark(const KaelArena *arena){
+	if(NULL_CHECK(arena)){return 0;}
+	return arena->top;
+}
+
+/**
+ * @brief Release everything allocated after mark
+ */
+void kaelArena_rollback(KaelArena *arena, KaelArena_mark mark){
+	if(NULL_CHECK(arena)){return;}
+	KAEL_ASSERT(mark <= arena->top, "kaelArena_rollback to a mark that was already released");
+	arena->top = mark;
+	arena->last = KAEL_ARENA_NO_LAST;
+}
+
+/**
+ * @brief Release everything, call at frame end
+ */
+void kaelArena_reset(KaelArena *arena){
+	kaelArena_rollback(arena, 0);
+}
+
+
+
+
+//------ Getters ------
+
+uint32_t kaelArena_getUsed(const KaelArena *arena){
+	if(NULL_CHECK(arena)){return 0;}
+	return arena->top;
+}
+
+uint32_t kaelArena_getHighWater(const KaelArena *arena){
+	if(NULL_CHECK(arena)){return 0;}
+	return arena->highWater;
+}
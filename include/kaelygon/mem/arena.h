@@ -0,0 +1,52 @@
+/**
+ * @file arena.h
+ *
+ * @brief Header, bump arena for short lived allocations
+ *
+ * Allocation bumps an offset in one fixed buffer, nothing is freed individually.
+ * Mark and rollback release everything allocated after the mark, reset releases everything at frame end.
+ * Buffer can be provided by the caller, so an arena works without malloc
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "kaelygon/global/kaelMacros.h"
+
+//Every allocation is aligned for any type
+#define KAEL_ARENA_ALIGN (_Alignof(max_align_t))
+
+//No allocation can be grown in place
+#define KAEL_ARENA_NO_LAST UINT32_MAX
+
+typedef uint32_t KaelArena_mark;
+
+typedef struct KaelArena{
+	uint8_t *base;
+	uint32_t size; //buffer bytes
+	uint32_t top; //next free byte offset
+	uint32_t last; //offset of the latest allocation, it can grow in place
+	uint32_t highWater; //largest top since alloc
+	uint8_t ownsBuffer;
+}KaelArena;
+
+//------ Alloc / Free ------
+uint8_t kaelArena_alloc(KaelArena *arena, uint32_t size, uint8_t *buffer);
+void kaelArena_free(KaelArena *arena);
+
+//------ Allocate ------
+void *kaelArena_push(KaelArena *arena, uint32_t bytes);
+void *kaelArena_pushZero(KaelArena *arena, uint32_t bytes);
+void *kaelArena_resize(KaelArena *arena, void *ptr, uint32_t oldBytes, uint32_t newBytes);
+
+//------ Release ------
+KaelArena_mark kaelArena_mark(const KaelArena *arena);
+void kaelArena_rollback(KaelArena *arena, KaelArena_mark mark);
+void kaelArena_reset(KaelArena *arena);
+
+//------ Getters ------
+uint32_t kaelArena_getUsed(const KaelArena *arena);
+uint32_t kaelArena_getHighWater(const KaelArena *arena);
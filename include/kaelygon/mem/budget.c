@@ -0,0 +1,375 @@
+/**
+ * @file budget.c
+ *
+ * @brief Implementation, fixed memory budget made of 64 KiB banks
+ *
+ * Every block starts with a one granule header holding its length and the length of the block before it,
+ * so release merges free neighbours in O(1) and a bank never holds two free blocks side by side.
+ * Acquire walks the blocks of banks that have enough free granules in total, lowest bank first.
+ * Region and bank table come from the system allocator once, blocks never do
+ */
+
+#include <string.h>
+
+#include "kaelygon/mem/budget.h"
+
+#define BANK_GRANULES (KAEL_BUDGET_BANK_BYTES / KAEL_BUDGET_GRANULE)
+
+typedef struct{
+	uint16_t granules; //block length including header. Banks covered for a span block
+	uint16_t prevGranules; //length of previous block in bank, 0 for the first block
+	uint32_t bytes; //requested bytes
+	uint8_t used;
+	uint8_t reserved[7]; //pad to one granule
+}KaelBudget_header;
+
+_Static_assert(sizeof(KaelBudget_header) == KAEL_BUDGET_GRANULE, "KaelBudget_header must be one granule");
+
+
+
+
+//------ Private ------
+
+uint8_t *_kaelBudget_bank(const KaelBudget *budget, uint16_t bank){
+	return budget->region + (size_t)bank * KAEL_BUDGET_BANK_BYTES;
+}
+
+KaelBudget_header *_kaelBudget_block(const KaelBudget *budget, uint16_t bank, uint16_t granule){
+	return (KaelBudget_header *)(_kaelBudget_bank(budget, bank) + (size_t)granule * KAEL_BUDGET_GRANULE);
+}
+
+uint16_t _kaelBudget_granuleOf(const KaelBudget *budget, const KaelBudget_header *header, uint16_t bank){
+	return (uint16_t)(((const uint8_t *)header - _kaelBudget_bank(budget, bank)) / KAEL_BUDGET_GRANULE);
+}
+
+//Empty bank is one free block
+void _kaelBudget_clearBank(KaelBudget *budget, uint16_t bank){
+	KaelBudget_header *header = _kaelBudget_block(budget, bank, 0);
+	*header = (KaelBudget_header){ .granules = BANK_GRANULES };
+	budget->bankMode[bank] = KAEL_BUDGET_BANK_SLICED;
+	budget->bankFree[bank] = BANK_GRANULES;
+}
+
+void _kaelBudget_addUsed(KaelBudget *budget, size_t bytes){
+	budget->used += bytes;
+	budget->peak = budget->used > budget->peak ? budget->used : budget->peak;
+}
+
+//Fix prevGranules of the block after granule, if there is one in the bank
+void _kaelBudget_linkNext(KaelBudget *budget, uint16_t bank, uint16_t granule){
+	KaelBudget_header *header = _kaelBudget_block(budget, bank, granule);
+	uint32_t next = (uint32_t)granule + header->granules;
+	if(next < BANK_GRANULES){
+		_kaelBudget_block(budget, bank, (uint16_t)next)->prevGranules = header->granules;
+	}
+}
+
+/**
+ * @brief Cut block at granule to need granules, rest becomes a free block
+ * @note Block after the block must not be free, or two free blocks would be neighbours
+ */
+void _kaelBudget_split(KaelBudget *budget, uint16_t bank, uint16_t granule, uint16_t need){
+	KaelBudget_header *header = _kaelBudget_block(budget, bank, granule);
+	if(header->granules <= need){return;}
+
+	uint16_t restGranule = granule + need;
+	KaelBudget_header *rest = _kaelBudget_block(budget, bank, restGranule);
+	*rest = (KaelBudget_header){ .granules = header->granules - need, .prevGranules = need };
+	header->granules = need;
+	_kaelBudget_linkNext(budget, bank, restGranule);
+}
+
+//Granules for bytes plus header, 0 if it doesn't fit a bank. Zero bytes still gets a data granule so the pointer is inside the block
+uint16_t _kaelBudget_granules(size_t bytes){
+	if(bytes > KAEL_BUDGET_BANK_BYTES - KAEL_BUDGET_GRANULE){return 0;}
+	bytes = bytes==0 ? 1 : bytes;
+	return (uint16_t)((bytes + 2U*KAEL_BUDGET_GRANULE - 1U) / KAEL_BUDGET_GRANULE);
+}
+
+void *_kaelBudget_acquireSliced(KaelBudget *budget, size_t bytes, uint16_t need){
+	for(uint16_t bank=0; bank<budget->bankCount; bank++){
+		if(budget->bankMode[bank]!=KAEL_BUDGET_BANK_SLICED || budget->bankFree[bank] < need){continue;}
+
+		for(uint32_t granule=0; granule<BANK_GRANULES; ){
+			KaelBudget_header *header = _kaelBudget_block(budget, bank, (uint16_t)granule);
+			if(!header->used && header->granules >= need){
+				_kaelBudget_split(budget, bank, (uint16_t)granule, need);
+				header->used = 1;
+				header->bytes = (uint32_t)bytes;
+				budget->bankFree[bank] -= need;
+				_kaelBudget_addUsed(budget, (size_t)need * KAEL_BUDGET_GRANULE);
+				return header + 1;
+			}
+			granule += header->granules;
+		}
+	}
+	return NULL;
+}
+
+//Take whole consecutive empty banks for a block larger than a bank
+void *_kaelBudget_acquireSpan(KaelBudget *budget, size_t bytes){
+	size_t spanBytes = bytes + KAEL_BUDGET_GRANULE;
+	size_t banks = (spanBytes + KAEL_BUDGET_BANK_BYTES - 1U) / KAEL_BUDGET_BANK_BYTES;
+	if(bytes > UINT32_MAX || banks > budget->bankCount){return NULL;}
+
+	uint16_t run = 0;
+	for(uint16_t bank=0; bank<budget->bankCount; bank++){
+		uint8_t empty = budget->bankMode[bank]==KAEL_BUDGET_BANK_SLICED && budget->bankFree[bank]==BANK_GRANULES;
+		run = empty ? run + 1U : 0;
+		if(run < banks){continue;}
+
+		uint16_t first = bank + 1U - run;
+		for(uint16_t i=first; i<=bank; i++){
+			budget->bankMode[i] = KAEL_BUDGET_BANK_SPAN_REST;
+			budget->bankFree[i] = 0;
+		}
+		budget->bankMode[first] = KAEL_BUDGET_BANK_SPAN;
+
+		KaelBudget_header *header = _kaelBudget_block(budget, first, 0);
+		*header = (KaelBudget_header){ .granules = run, .bytes = (uint32_t)bytes, .used = 1 };
+		_kaelBudget_addUsed(budget, (size_t)run * KAEL_BUDGET_BANK_BYTES);
+		return header + 1;
+	}
+	return NULL;
+}
+
+
+
+
+//------ Alloc / Free ------
+
+/**
+ * @brief Initialize budget of bankCount banks
+ *
+ * @note Optionally provide *buffer of bankCount*KAEL_BUDGET_BANK_BYTES bytes aligned to KAEL_BUDGET_GRANULE. Otherwise the region is allocated to heap once
+ * @return Kael_infoCode
+ */
+uint8_t kaelBudget_alloc(KaelBudget *budget, uint16_t bankCount, uint8_t *buffer){
+	if(NULL_CHECK(budget)){return KAEL_ERR_NULL;}
+	*budget = (KaelBudget){0};
+	if(bankCount==0 || ((uintptr_t)buffer % KAEL_BUDGET_GRANULE)!=0){
+		KAEL_ERROR_NOTE("kaelBudget_alloc needs a bank and granule aligned buffer");
+		return KAEL_ERR_UNSUPPORTED;
+	}
+
+	//Bank table, mode bytes after the free counts
+	budget->bankFree = malloc((size_t)bankCount * (sizeof(uint16_t) + sizeof(uint8_t)));
+	if(budget->bankFree==NULL){
+		KAEL_ERROR_NOTE("kaelBudget_alloc bank table failed");
+		return KAEL_ERR_ALLOC;
+	}
+	budget->bankMode = (uint8_t *)(budget->bankFree + bankCount);
+
+	if(buffer==NULL){
+		budget->region = malloc((size_t)bankCount * KAEL_BUDGET_BANK_BYTES);
+		if(budget->region==NULL){
+			KAEL_ERROR_NOTE("kaelBudget_alloc region failed");
+			free(budget->bankFree);
+			*budget = (KaelBudget){0};
+			return KAEL_ERR_ALLOC;
+		}
+		budget->ownsRegion = 1;
+	}else{
+		budget->region = buffer;
+	}
+
+	budget->bankCount = bankCount;
+	for(uint16_t bank=0; bank<bankCount; bank++){
+		_kaelBudget_clearBank(budget, bank);
+	}
+	return KAEL_SUCCESS;
+}
+
+/**
+ * @brief Free region and bank table
+ *
+ * @note Every block is gone afterwards, acquired or not
+ */
+void kaelBudget_free(KaelBudget *budget){
+	if(NULL_CHECK(budget)){return;}
+	if(budget->ownsRegion){
+		free(budget->region);
+	}
+	free(budget->bankFree);
+	*budget = (KaelBudget){0};
+}
+
+
+
+
+//------ Blocks ------
+
+/**
+ * @brief malloc() from the budget
+ * @return Address aligned to KAEL_BUDGET_GRANULE, NULL if budget is exhausted
+ */
+void *kaelBudget_acquire(KaelBudget *budget, size_t bytes){
+	if(NULL_CHECK(budget)){return NULL;}
+	uint16_t need = _kaelBudget_granules(bytes);
+	void *ptr = need ? _kaelBudget_acquireSliced(budget, bytes, need) : _kaelBudget_acquireSpan(budget, bytes);
+	if(ptr==NULL){
+		budget->failures++;
+		KAEL_ERROR_NOTE("KaelBudget exhausted");
+	}
+	return ptr;
+}
+
+/**
+ * @brief free() to the budget, neighbouring free blocks are merged
+ */
+void kaelBudget_release(KaelBudget *budget, void *ptr){
+	if(NULL_CHECK(budget) || ptr==NULL){return;}
+	KAEL_ASSERT(kaelBudget_owns(budget, ptr), "kaelBudget_release pointer outside budget");
+
+	KaelBudget_header *header = (KaelBudget_header *)ptr - 1;
+	uint16_t bank = (uint16_t)(((uint8_t *)header - budget->region) / KAEL_BUDGET_BANK_BYTES);
+
+	if(budget->bankMode[bank]==KAEL_BUDGET_BANK_SPAN){
+		uint16_t banks = header->granules;
+		budget->used -= (size_t)banks * KAEL_BUDGET_BANK_BYTES;
+		for(uint16_t i=bank; i<bank+banks; i++){
+			_kaelBudget_clearBank(budget, i);
+		}
+		return;
+	}
+
+	uint16_t granule = _kaelBudget_granuleOf(budget, header, bank);
+	header->used = 0;
+	budget->bankFree[bank] += header->granules;
+	budget->used -= (size_t)header->granules * KAEL_BUDGET_GRANULE;
+
+	//Merge with next free block
+	uint32_t next = (uint32_t)granule + header->granules;
+	if(next < BANK_GRANULES){
+		KaelBudget_header *nextHeader = _kaelBudget_block(budget, bank, (uint16_t)next);
+		if(!nextHeader->used){
+			header->granules += nextHeader->granules;
+			_kaelBudget_linkNext(budget, bank, granule);
+		}
+	}
+
+	//Merge into previous free block
+	if(header->prevGranules){
+		uint16_t prev = granule - header->prevGranules;
+		KaelBudget_header *prevHeader = _kaelBudget_block(budget, bank, prev);
+		if(!prevHeader->used){
+			prevHeader->granules += header->granules;
+			_kaelBudget_linkNext(budget, bank, prev);
+		}
+	}
+}
+
+/**
+ * @brief realloc() within the budget. Grows in place into a following free block, otherwise moves
+ * @return New address or NULL. Original block is kept on failure
+ */
+void *kaelBudget_resize(KaelBudget *budget, void *ptr, size_t bytes){
+	if(NULL_CHECK(budget)){return NULL;}
+	if(ptr==NULL){return kaelBudget_acquire(budget, bytes);}
+	KAEL_ASSERT(kaelBudget_owns(budget, ptr), "kaelBudget_resize pointer outside budget");
+
+	KaelBudget_header *header = (KaelBudget_header *)ptr - 1;
+	uint16_t bank = (uint16_t)(((uint8_t *)header - budget->region) / KAEL_BUDGET_BANK_BYTES);
+	uint16_t need = _kaelBudget_granules(bytes);
+
+	if(budget->bankMode[bank]==KAEL_BUDGET_BANK_SLICED && need){
+		uint16_t granule = _kaelBudget_granuleOf(budget, header, bank);
+		if(need <= header->granules){
+			header->bytes = (uint32_t)bytes;
+			return ptr;
+		}
+
+		//Absorb next free block if the two fit
+		uint32_t next = (uint32_t)granule + header->granules;
+		if(next < BANK_GRANULES){
+			KaelBudget_header *nextHeader = _kaelBudget_block(budget, bank, (uint16_t)next);
+			if(!nextHeader->used && header->granules + nextHeader->granules >= need){
+				uint16_t oldGranules = header->granules;
+				header->granules += nextHeader->granules;
+				_kaelBudget_linkNext(budget, bank, granule);
+				_kaelBudget_split(budget, bank, granule, need);
+				budget->bankFree[bank] -= need - oldGranules;
+				_kaelBudget_addUsed(budget, (size_t)(need - oldGranules) * KAEL_BUDGET_GRANULE);
+				header->bytes = (uint32_t)bytes;
+				return ptr;
+			}
+		}
+	}else if(budget->bankMode[bank]==KAEL_BUDGET_BANK_SPAN && !need){
+		size_t banks = (bytes + KAEL_BUDGET_GRANULE + KAEL_BUDGET_BANK_BYTES - 1U) / KAEL_BUDGET_BANK_BYTES;
+		if(banks <= header->granules){
+			header->bytes = (uint32_t)bytes;
+			return ptr;
+		}
+	}
+
+	void *newPtr = kaelBudget_acquire(budget, bytes);
+	if(newPtr==NULL){return NULL;}
+	memcpy(newPtr, ptr, header->bytes < bytes ? header->bytes : bytes);
+	kaelBudget_release(budget, ptr);
+	return newPtr;
+}
+
+uint8_t kaelBudget_owns(const KaelBudget *budget, const void *ptr){
+	if(NULL_CHECK(budget)){return 0;}
+	const uint8_t *byte = ptr;
+	return byte >= budget->region && byte < budget->region + (size_t)budget->bankCount * KAEL_BUDGET_BANK_BYTES;
+}
+
+
+
+
+//------ Report ------
+
+/**
+ * @brief Walk every bank for free block totals
+ */
+KaelBudget_stats kaelBudget_getStats(const KaelBudget *budget){
+	if(NULL_CHECK(budget)){return (KaelBudget_stats){0};}
+	KaelBudget_stats stats = {
+		.capacity = (size_t)budget->bankCount * KAEL_BUDGET_BANK_BYTES,
+		.used = budget->used,
+		.peak = budget->peak,
+		.failures = budget->failures
+	};
+
+	size_t largestBlock = 0;
+	uint16_t emptyRun = 0;
+	uint16_t longestRun = 0;
+	for(uint16_t bank=0; bank<budget->bankCount; bank++){
+		if(budget->bankMode[bank]!=KAEL_BUDGET_BANK_SLICED){
+			stats.banksUsed++;
+			emptyRun = 0;
+			continue;
+		}
+		stats.banksUsed += budget->bankFree[bank]!=BANK_GRANULES;
+		emptyRun = budget->bankFree[bank]==BANK_GRANULES ? emptyRun + 1U : 0;
+		longestRun = emptyRun > longestRun ? emptyRun : longestRun;
+
+		for(uint32_t granule=0; granule<BANK_GRANULES; ){
+			const KaelBudget_header *header = _kaelBudget_block(budget, bank, (uint16_t)granule);
+			if(!header->used){
+				size_t blockBytes = (size_t)header->granules * KAEL_BUDGET_GRANULE;
+				stats.free += blockBytes;
+				stats.freeBlocks++;
+				largestBlock = blockBytes > largestBlock ? blockBytes : largestBlock;
+			}
+			granule += header->granules;
+		}
+	}
+
+	//Consecutive empty banks serve one span block
+	size_t runBytes = (size_t)longestRun * KAEL_BUDGET_BANK_BYTES;
+	largestBlock = runBytes > largestBlock ? runBytes : largestBlock;
+	stats.largestFree = largestBlock ? largestBlock - KAEL_BUDGET_GRANULE : 0;
+	stats.fragmentation = stats.free ? (uint8_t)(100U - largestBlock * 100U / stats.free) : 0;
+	return stats;
+}
+
+void kaelBudget_report(const KaelBudget *budget, FILE *stream){
+	if(NULL_CHECK(budget) || NULL_CHECK(stream)){return;}
+	KaelBudget_stats stats = kaelBudget_getStats(budget);
+	fprintf(stream, "budget   %u banks, %zu bytes\n", budget->bankCount, stats.capacity);
+	fprintf(stream, "used     %zu bytes, peak %zu, %u banks touched\n", stats.used, stats.peak, stats.banksUsed);
+	fprintf(stream, "free     %zu bytes in %u blocks, largest acquire %zu\n", stats.free, stats.freeBlocks, stats.largestFree);
+	fprintf(stream, "fragment %u%%, failed acquires %u\n", stats.fragmentation, stats.failures);
+}
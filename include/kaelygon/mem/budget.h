@@ -0,0 +1,65 @@
+/**
+ * @file budget.h
+ *
+ * @brief Header, fixed memory budget made of 64 KiB banks, like the banked RAM of a 16-bit system
+ *
+ * Blocks are carved from a bank first fit and never cross a bank edge, so an offset within a bank always fits 16 bits.
+ * Allocations larger than a bank take whole consecutive empty banks. When the budget is exhausted acquire returns NULL,
+ * the same call fails on every run since nothing depends on the system allocator
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "kaelygon/global/kaelMacros.h"
+
+#define KAEL_BUDGET_BANK_BYTES (UINT16_MAX+1U)
+
+//Block header and alignment unit, user memory is aligned like malloc
+#define KAEL_BUDGET_GRANULE 16U
+
+typedef enum{
+	KAEL_BUDGET_BANK_SLICED = 0, //bank holds a chain of blocks
+	KAEL_BUDGET_BANK_SPAN, //first bank of a block larger than a bank
+	KAEL_BUDGET_BANK_SPAN_REST //covered by the span block before it
+}KaelBudget_bankMode;
+
+typedef struct KaelBudget{
+	uint8_t *region; //bankCount*KAEL_BUDGET_BANK_BYTES bytes
+	uint8_t *bankMode; //KaelBudget_bankMode per bank
+	uint16_t *bankFree; //free granules per sliced bank
+	uint16_t bankCount;
+	size_t used; //bytes in acquired blocks including headers
+	size_t peak; //highest used
+	uint32_t failures; //acquires that didn't fit
+	uint8_t ownsRegion;
+}KaelBudget;
+
+typedef struct{
+	size_t capacity; //region bytes
+	size_t used;
+	size_t peak;
+	size_t free; //bytes in free blocks including headers
+	size_t largestFree; //largest acquire that would succeed
+	uint32_t freeBlocks;
+	uint32_t failures;
+	uint16_t banksUsed; //banks with at least one acquired block
+	uint8_t fragmentation; //percent of free bytes outside the largest free block
+}KaelBudget_stats;
+
+//------ Alloc / Free ------
+uint8_t kaelBudget_alloc(KaelBudget *budget, uint16_t bankCount, uint8_t *buffer);
+void kaelBudget_free(KaelBudget *budget);
+
+//------ Blocks ------
+void *kaelBudget_acquire(KaelBudget *budget, size_t bytes);
+void *kaelBudget_resize(KaelBudget *budget, void *ptr, size_t bytes);
+void kaelBudget_release(KaelBudget *budget, void *ptr);
+uint8_t kaelBudget_owns(const KaelBudget *budget, const void *ptr);
+
+//------ Report ------
+KaelBudget_stats kaelBudget_getStats(const KaelBudget *budget);
+void kaelBudget_report(const KaelBudget *budget, FILE *stream);
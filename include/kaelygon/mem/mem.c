@@ -0,0 +1,246 @@
+/**
+ * @file mem.c
+ *
+ * @brief Implementation, tagged heap allocation with per subsystem byte counters
+ *
+ * Every tracked allocation is prefixed by a header holding its byte count and tag,
+ * so kaelMem_free and kaelMem_realloc know what to subtract without the caller passing sizes.
+ * Blocks come from the system heap, or from a KaelBudget of KAEL_MEM_BUDGET banks made on first use.
+ * Counters and budget are plain globals, allocate from one thread at a time
+ */
+
+#include <string.h>
+#include <stdalign.h>
+
+#include "kaelygon/global/kaelMacros.h"
+#include "kaelygon/mem/mem.h"
+#include "kaelygon/mem/budget.h"
+
+typedef struct{
+	alignas(max_align_t) size_t bytes; //keeps user memory aligned like malloc
+	uint8_t tag;
+}KaelMem_header;
+
+KaelMem_stats _kaelMem_stats[KAEL_MEM_TAG_COUNT] = {0};
+KaelMem_stats _kaelMem_total = {0};
+uint8_t _kaelMem_hot = 0;
+KaelBudget _kaelMem_budget = {0};
+
+const char *_kaelMem_tagNames[KAEL_MEM_TAG_COUNT] = {
+	"tree",
+	"string",
+	"book",
+	"krle",
+	"audio",
+	"other"
+};
+
+
+
+
+//------ Private ------
+
+KaelMem_header *_kaelMem_header(void *ptr){
+	return (KaelMem_header *)ptr - 1;
+}
+
+void _kaelMem_add(KaelMem_stats *stats, size_t bytes){
+	stats->live += bytes;
+	stats->peak = stats->live > stats->peak ? stats->live : stats->peak;
+}
+
+void _kaelMem_count(KaelMem_tag tag, size_t addBytes, size_t subBytes){
+	KaelMem_stats *stats[2] = {&_kaelMem_stats[tag], &_kaelMem_total};
+	for(uint8_t i=0; i<2; i++){
+		stats[i]->live -= subBytes;
+		_kaelMem_add(stats[i], addBytes);
+	}
+}
+
+KaelMem_tag _kaelMem_validTag(KaelMem_tag tag){
+	return tag < KAEL_MEM_TAG_COUNT ? tag : KAEL_MEM_OTHER;
+}
+
+//Block source, system heap or the budget
+#if KAEL_MEM_BUDGET>0
+	_Static_assert(KAEL_MEM_BUDGET <= UINT16_MAX, "KAEL_MEM_BUDGET is a 16-bit bank count");
+
+	KaelBudget *_kaelMem_budgetReady(){
+		if(_kaelMem_budget.region==NULL){
+			kaelBudget_alloc(&_kaelMem_budget, KAEL_MEM_BUDGET, NULL);
+		}
+		return &_kaelMem_budget;
+	}
+	void *_kaelMem_blockAlloc(size_t bytes){
+		KaelBudget *budget = _kaelMem_budgetReady();
+		return budget->region==NULL ? NULL : kaelBudget_acquire(budget, bytes);
+	}
+	void *_kaelMem_blockRealloc(void *block, size_t bytes){
+		return kaelBudget_resize(&_kaelMem_budget, block, bytes);
+	}
+	void _kaelMem_blockFree(void *block){
+		kaelBudget_release(&_kaelMem_budget, block);
+	}
+#else
+	void *_kaelMem_blockAlloc(size_t bytes){
+		return malloc(bytes);
+	}
+	void *_kaelMem_blockRealloc(void *block, size_t bytes){
+		return realloc(block, bytes);
+	}
+	void _kaelMem_blockFree(void *block){
+		free(block);
+	}
+#endif
+
+
+
+
+//------ Tracked allocation ------
+
+void *kaelMem_malloc(KaelMem_tag tag, size_t bytes){
+	if(bytes > SIZE_MAX - sizeof(KaelMem_header)){return NULL;}
+	KaelMem_header *header = _kaelMem_blockAlloc(sizeof(KaelMem_header) + bytes);
+	if(header==NULL){
+		KAEL_ERROR_NOTE("kaelMem_malloc failed");
+		return NULL;
+	}
+	tag = _kaelMem_validTag(tag);
+	header->bytes = bytes;
+	header->tag = tag;
+
+	_kaelMem_count(tag, bytes, 0);
+	_kaelMem_stats[tag].allocs++;
+	_kaelMem_total.allocs++;
+	return header + 1;
+}
+
+void *kaelMem_calloc(KaelMem_tag tag, size_t count, size_t size){
+	if(size!=0 && count > SIZE_MAX / size){return NULL;}
+	void *ptr = kaelMem_malloc(tag, count * size);
+	if(ptr!=NULL){
+		memset(ptr, 0, count * size);
+	}
+	return ptr;
+}
+
+/**
+ * @brief realloc() that keeps the tag of the original allocation. NULL ptr allocates and counts as an alloc, zero bytes frees
+ * @return New address or NULL. Original allocation is kept on failure
+ */
+void *kaelMem_realloc(KaelMem_tag tag, void *ptr, size_t bytes){
+	if(ptr==NULL){
+		return kaelMem_malloc(tag, bytes);
+	}
+	if(bytes==0){
+		kaelMem_free(ptr);
+		return NULL;
+	}
+	if(bytes > SIZE_MAX - sizeof(KaelMem_header)){return NULL;}
+
+	KaelMem_header *header = _kaelMem_blockRealloc(_kaelMem_header(ptr), sizeof(KaelMem_header) + bytes);
+	if(header==NULL){
+		KAEL_ERROR_NOTE("kaelMem_realloc failed");
+		return NULL;
+	}
+	tag = header->tag;
+	_kaelMem_count(tag, bytes, header->bytes);
+	header->bytes = bytes;
+
+	_kaelMem_stats[tag].reallocs++;
+	_kaelMem_stats[tag].hotReallocs += _kaelMem_hot;
+	_kaelMem_total.reallocs++;
+	_kaelMem_total.hotReallocs += _kaelMem_hot;
+	return header + 1;
+}
+
+void kaelMem_free(void *ptr){
+	if(ptr==NULL){return;}
+	KaelMem_header *header = _kaelMem_header(ptr);
+	KaelMem_tag tag = header->tag;
+	_kaelMem_count(tag, 0, header->bytes);
+	_kaelMem_stats[tag].frees++;
+	_kaelMem_total.frees++;
+	_kaelMem_blockFree(header);
+}
+
+
+
+
+//------ Counters ------
+
+//Mark the main loop, reallocs in it are counted separately as they cost every frame
+void kaelMem_setHot(uint8_t state){
+	_kaelMem_hot = state ? 1 : 0;
+}
+
+KaelMem_stats kaelMem_getStats(KaelMem_tag tag){
+	if(tag >= KAEL_MEM_TAG_COUNT){return (KaelMem_stats){0};}
+	return _kaelMem_stats[tag];
+}
+
+//All tags combined, peak is the highest sum of live bytes rather than sum of peaks
+KaelMem_stats kaelMem_getTotal(){
+	return _kaelMem_total;
+}
+
+//Start peak measurement over from current live bytes
+void kaelMem_resetPeak(){
+	for(uint8_t i=0; i<KAEL_MEM_TAG_COUNT; i++){
+		_kaelMem_stats[i].peak = _kaelMem_stats[i].live;
+	}
+	_kaelMem_total.peak = _kaelMem_total.live;
+}
+
+
+
+
+//------ Report ------
+
+const char *kaelMem_tagName(KaelMem_tag tag){
+	return tag < KAEL_MEM_TAG_COUNT ? _kaelMem_tagNames[tag] : "invalid";
+}
+
+void _kaelMem_printRow(FILE *stream, const char *name, const KaelMem_stats *stats){
+	fprintf(stream, "%-8s %10zu %10zu %8u %8u %8u %8u\n", name, stats->live, stats->peak,
+		stats->allocs, stats->frees, stats->reallocs, stats->hotReallocs);
+}
+
+void kaelMem_report(FILE *stream){
+	if(NULL_CHECK(stream)){return;}
+	fprintf(stream, "%-8s %10s %10s %8s %8s %8s %8s\n", "memory", "live", "peak", "allocs", "frees", "reallocs", "hot");
+	for(uint8_t i=0; i<KAEL_MEM_TAG_COUNT; i++){
+		_kaelMem_printRow(stream, _kaelMem_tagNames[i], &_kaelMem_stats[i]);
+	}
+	_kaelMem_printRow(stream, "all", &_kaelMem_total);
+	#if KAEL_MEM_WRAP!=1
+		fprintf(stream, "Built without KAEL_MEM_TRACK, only direct kaelMem calls are counted\n");
+	#endif
+	if(_kaelMem_budget.region!=NULL){
+		kaelBudget_report(&_kaelMem_budget, stream);
+	}
+}
+
+void _kaelMem_reportStderr(){
+	kaelMem_report(stderr);
+}
+
+//Print report to stderr when program exits
+void kaelMem_reportAtExit(){
+	atexit(_kaelMem_reportStderr);
+}
+
+
+
+
+//------ Budget ------
+
+//Budget that serves KAEL_MALLOC with KAEL_MEM_BUDGET, NULL otherwise or if the region couldn't be allocated
+KaelBudget *kaelMem_getBudget(){
+	#if KAEL_MEM_BUDGET>0
+		KaelBudget *budget = _kaelMem_budgetReady();
+		return budget->region==NULL ? NULL : budget;
+	#else
+		return NULL;
+	#endif
+}
@@ -0,0 +1,87 @@
+/**
+ * @file mem.h
+ *
+ * @brief Header, tagged heap allocation with per subsystem byte counters
+ *
+ * Subsystems allocate through KAEL_MALLOC, KAEL_CALLOC, KAEL_REALLOC and KAEL_FREE. Built with KAEL_MEM_TRACK 1
+ * they count live bytes, peak bytes and calls per KaelMem_tag, otherwise they are plain libc calls.
+ * Built with KAEL_MEM_BUDGET set to a bank count, every tracked allocation is served from a KaelBudget of that many
+ * 64 KiB banks instead of the system heap, so the program runs within the target memory.
+ * Memory from KAEL_MALLOC, KAEL_CALLOC or KAEL_REALLOC must be released by KAEL_FREE, never by free()
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+typedef struct KaelBudget KaelBudget; //kaelygon/mem/budget.h
+
+//CMake option MEM_TRACK generates this macro
+#ifndef KAEL_MEM_TRACK
+	#define KAEL_MEM_TRACK 0
+#endif
+
+//CMake option MEM_BUDGET generates this macro, 0 uses the system heap
+#ifndef KAEL_MEM_BUDGET
+	#define KAEL_MEM_BUDGET 0
+#endif
+
+//Budget has to count live blocks too, so it implies tracking
+#if KAEL_MEM_TRACK==1 || KAEL_MEM_BUDGET>0
+	#define KAEL_MEM_WRAP 1
+#else
+	#define KAEL_MEM_WRAP 0
+#endif
+
+typedef enum{
+	KAEL_MEM_TREE = 0, //KaelTree, typed trees and other containers
+	KAEL_MEM_STRING, //KaelStr and KaelGapStr
+	KAEL_MEM_BOOK, //Book row buffer and shape strings
+	KAEL_MEM_KRLE, //Decoded pixels and KRLE strings
+	KAEL_MEM_AUDIO, //Waveform, mixer and effect buffers
+	KAEL_MEM_OTHER, //Pools, arenas and everything else
+	KAEL_MEM_TAG_COUNT
+}KaelMem_tag;
+
+typedef struct{
+	size_t live; //bytes allocated now
+	size_t peak; //highest live
+	uint32_t allocs; //malloc and calloc calls
+	uint32_t frees;
+	uint32_t reallocs;
+	uint32_t hotReallocs; //reallocs while kaelMem_setHot is on
+}KaelMem_stats;
+
+#if KAEL_MEM_WRAP==1
+	#define KAEL_MALLOC(tag, bytes) kaelMem_malloc(tag, bytes)
+	#define KAEL_CALLOC(tag, count, size) kaelMem_calloc(tag, count, size)
+	#define KAEL_REALLOC(tag, ptr, bytes) kaelMem_realloc(tag, ptr, bytes)
+	#define KAEL_FREE(ptr) kaelMem_free(ptr)
+#else
+	#define KAEL_MALLOC(tag, bytes) ((void)(tag), malloc(bytes))
+	#define KAEL_CALLOC(tag, count, size) ((void)(tag), calloc(count, size))
+	#define KAEL_REALLOC(tag, ptr, bytes) ((void)(tag), realloc(ptr, bytes))
+	#define KAEL_FREE(ptr) free(ptr)
+#endif
+
+//------ Tracked allocation ------
+void *kaelMem_malloc(KaelMem_tag tag, size_t bytes);
+void *kaelMem_calloc(KaelMem_tag tag, size_t count, size_t size);
+void *kaelMem_realloc(KaelMem_tag tag, void *ptr, size_t bytes);
+void kaelMem_free(void *ptr);
+
+//------ Counters ------
+void kaelMem_setHot(uint8_t state);
+KaelMem_stats kaelMem_getStats(KaelMem_tag tag);
+KaelMem_stats kaelMem_getTotal();
+void kaelMem_resetPeak();
+
+//------ Report ------
+const char *kaelMem_tagName(KaelMem_tag tag);
+void kaelMem_report(FILE *stream);
+void kaelMem_reportAtExit();
+
+//------ Budget ------
+KaelBudget *kaelMem_getBudget();
@@ -0,0 +1,203 @@
+/**
+ * @file pool.c
+ *
+ * @brief Implementation, pool of fixed size slots addressed by 16-bit handles
+ *
+ * Slots past untouched are handed out in order before the free list is used, so alloc doesn't have to link every slot.
+ * Release bumps slot generation, any handle acquired before that no longer matches it
+ */
+
+#include "kaelygon/mem/pool.h"
+#include "kaelygon/mem/mem.h"
+
+
+
+
+//------ Private ------
+
+uint16_t _kaelPool_index(const KaelPool *pool, KaelPool_handle handle){
+	return handle & (uint16_t)((1U << pool->indexBits) - 1U);
+}
+
+uint8_t _kaelPool_generationMask(const KaelPool *pool){
+	return (uint8_t)((1U << (16U - pool->indexBits)) - 1U);
+}
+
+uint16_t _kaelPool_stride(uint16_t width){
+	return width < sizeof(uint16_t) ? sizeof(uint16_t) : width;
+}
+
+
+
+
+//------ Alloc / Free ------
+
+/**
+ * @brief Bytes needed for a caller provided kaelPool_alloc buffer
+ */
+uint32_t kaelPool_bufferBytes(uint16_t width, uint16_t capacity, uint8_t generationBits){
+	uint32_t bytes = (uint32_t)_kaelPool_stride(width) * capacity;
+	return generationBits ? bytes + capacity : bytes;
+}
+
+/**
+ * @brief Initialize pool of capacity slots that are width bytes each
+ *
+ * @param generationBits 0 to disable use-after-release checks. Each bit halves the largest capacity
+ * @note Optionally provide *buffer of at least kaelPool_bufferBytes. Otherwise the buffer is allocated to heap once
+ * @return Kael_infoCode
+ */
+uint8_t kaelPool_alloc(KaelPool *pool, uint16_t width, uint16_t capacity, uint8_t generationBits, uint8_t *buffer){
+	if(NULL_CHECK(pool)){return KAEL_ERR_NULL;}
+	*pool = (KaelPool){0};
+
+	if(generationBits > KAEL_POOL_GENERATION_MAX){
+		KAEL_ERROR_NOTE("kaelPool_alloc too many generation bits");
+		return KAEL_ERR_UNSUPPORTED;
+	}
+	pool->indexBits = 16U - generationBits;
+
+	//All ones index is reserved so KAEL_POOL_INVALID never refers to a slot
+	uint16_t maxCapacity = (uint16_t)((1U << pool->indexBits) - 1U);
+	if(capacity > maxCapacity){
+		KAEL_ERROR_NOTE("kaelPool_alloc capacity doesn't fit handle index bits");
+		return KAEL_ERR_FULL;
+	}
+
+	pool->width = width;
+	pool->stride = _kaelPool_stride(width);
+	pool->capacity = capacity;
+	pool->freeHead = KAEL_POOL_INVALID;
+
+	uint32_t slotBytes = (uint32_t)pool->stride * capacity;
+	if(buffer==NULL){
+		pool->slot = KAEL_MALLOC(KAEL_MEM_OTHER, kaelPool_bufferBytes(width, capacity, generationBits));
+		if(NULL_CHECK(pool->slot)){return KAEL_ERR_ALLOC;}
+		pool->ownsBuffer = 1;
+	}else{
+		pool->slot = buffer;
+	}
+
+	if(generationBits){
+		pool->generation = pool->slot + slotBytes;
+		memset(pool->generation, 0, capacity);
+	}
+	return KAEL_SUCCESS;
+}
+
+/**
+ * @brief Free pool buffer
+ *
+ * @note Make sure to free allocated elements in slots
+ */
+void kaelPool_free(KaelPool *pool){
+	if(NULL_CHECK(pool)){return;}
+	if(pool->ownsBuffer){
+		KAEL_FREE(pool->slot);
+	}
+	*pool = (KaelPool){0};
+}
+
+
+
+
+//------ Acquire / Release ------
+
+/**
+ * @brief Take a zeroed slot
+ * @return Slot handle or KAEL_POOL_INVALID if pool is full
+ */
+KaelPool_handle kaelPool_acquire(KaelPool *pool){
+	if(NULL_CHECK(pool)){return KAEL_POOL_INVALID;}
+
+	uint16_t index;
+	if(pool->freeHead != KAEL_POOL_INVALID){
+		index = pool->freeHead;
+		memcpy(&pool->freeHead, pool->slot + (uint32_t)index * pool->stride, sizeof(uint16_t));
+	}else
+	if(pool->untouched < pool->capacity){
+		index = pool->untouched++;
+	}else{
+		return KAEL_POOL_INVALID;
+	}
+
+	memset(pool->slot + (uint32_t)index * pool->stride, 0, pool->stride);
+	pool->used++;
+
+	KaelPool_handle handle = index;
+	if(pool->generation != NULL){
+		handle |= (uint16_t)(pool->generation[index] << pool->indexBits);
+	}
+	return handle;
+}
+
+/**
+ * @brief Return slot to the pool. Handle and slot address are invalid afterwards
+ *
+ * @note Without generation bits releasing the same handle twice isn't detected
+ * @return KAEL_SUCCESS or KAEL_ERR_NULL if handle doesn't refer to an acquired slot
+ */
+uint8_t kaelPool_release(KaelPool *pool, KaelPool_handle handle){
+	if(NULL_CHECK(pool)){return KAEL_ERR_NULL;}
+	if(!kaelPool_valid(pool, handle)){
+		KAEL_ERROR_NOTE("kaelPool_release stale or invalid handle");
+		return KAEL_ERR_NULL;
+	}
+
+	uint16_t index = _kaelPool_index(pool, handle);
+	if(pool->generation != NULL){
+		pool->generation[index] = (pool->generation[index] + 1U) & _kaelPool_generationMask(pool);
+	}
+
+	memcpy(pool->slot + (uint32_t)index * pool->stride, &pool->freeHead, sizeof(uint16_t));
+	pool->freeHead = index;
+	pool->used--;
+	return KAEL_SUCCESS;
+}
+
+
+
+
+//------ Getters ------
+
+/**
+ * @brief Get slot address
+ * @return Slot address or NULL if handle is stale or invalid
+ *
+ * @warning No NULL_CHECK
+ */
+void *kaelPool_get(const KaelPool *pool, KaelPool_handle handle){
+	KAEL_ASSERT(pool!=NULL);
+	if(!kaelPool_valid(pool, handle)){
+		return NULL;
+	}
+	return pool->slot + (uint32_t)_kaelPool_index(pool, handle) * pool->stride;
+}
+
+/**
+ * @brief Check that handle refers to a slot that has been acquired. Generation has to match if enabled
+ * @return 1 if valid, 0 if not
+ *
+ * @warning No NULL_CHECK
+ */
+uint8_t kaelPool_valid(const KaelPool *pool, KaelPool_handle handle){
+	KAEL_ASSERT(pool!=NULL);
+	uint16_t index = _kaelPool_index(pool, handle);
+	if(index >= pool->untouched){
+		return 0;
+	}
+	if(pool->generation != NULL){
+		return pool->generation[index] == (handle >> pool->indexBits);
+	}
+	return 1;
+}
+
+uint16_t kaelPool_used(const KaelPool *pool){
+	if(NULL_CHECK(pool)){return 0;}
+	return pool->used;
+}
+
+uint16_t kaelPool_capacity(const KaelPool *pool){
+	if(NULL_CHECK(pool)){return 0;}
+	return pool->capacity;
+}
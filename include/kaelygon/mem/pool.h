@@ -0,0 +1,53 @@
+/**
+ * @file pool.h
+ *
+ * @brief Header, pool of fixed size slots addressed by 16-bit handles
+ *
+ * Acquire and release are O(1) and never call malloc, released slots are linked in an intrusive free list.
+ * Optional generation bits are stored in the upper handle bits, so a handle to a released slot is caught
+ * instead of silently pointing to whatever took the slot
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "kaelygon/global/kaelMacros.h"
+
+//Handle that never refers to a slot
+#define KAEL_POOL_INVALID UINT16_MAX
+
+//Largest generation bit count, generations are stored in one byte per slot
+#define KAEL_POOL_GENERATION_MAX 8U
+
+typedef uint16_t KaelPool_handle;
+
+typedef struct{
+	uint8_t *slot; //slot storage, free slots hold next free index in their first bytes
+	uint8_t *generation; //generation per slot, NULL if generationBits is 0
+	uint16_t stride; //slot byte size, at least 2 for the free list index
+	uint16_t width; //element byte width
+	uint16_t capacity; //number of slots
+	uint16_t untouched; //slots from this index onwards have never been acquired
+	uint16_t freeHead; //first released slot or KAEL_POOL_INVALID
+	uint16_t used; //acquired slots
+	uint8_t indexBits; //handle is generation<<indexBits | index
+	uint8_t ownsBuffer;
+}KaelPool;
+
+//------ Alloc / Free ------
+uint32_t kaelPool_bufferBytes(uint16_t width, uint16_t capacity, uint8_t generationBits);
+uint8_t kaelPool_alloc(KaelPool *pool, uint16_t width, uint16_t capacity, uint8_t generationBits, uint8_t *buffer);
+void kaelPool_free(KaelPool *pool);
+
+//------ Acquire / Release ------
+KaelPool_handle kaelPool_acquire(KaelPool *pool);
+uint8_t kaelPool_release(KaelPool *pool, KaelPool_handle handle);
+
+//------ Getters ------
+void *kaelPool_get(const KaelPool *pool, KaelPool_handle handle);
+uint8_t kaelPool_valid(const KaelPool *pool, KaelPool_handle handle);
+uint16_t kaelPool_used(const KaelPool *pool);
+uint16_t kaelPool_capacity(const KaelPool *pool);
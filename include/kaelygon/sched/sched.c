@@ -0,0 +1,304 @@
+/**
+ * @file sched.c
+ *
+ * @brief Implementation, main loop scheduler. Timer wheel releases periodic jobs, earliest deadline runs first
+ *
+ * A job is either in one wheel slot list or in the ready mask, never both.
+ * The loop sleeps only when nothing released fits, until the next occupied slot or release
+ */
+
+#include "kaelygon/sched/sched.h"
+
+#define KAEL_SCHED_SLOT_LENGTH (1ULL<<KAEL_SCHED_SLOT_SHIFT)
+#define KAEL_SCHED_SLOT_MASK (KAEL_SCHED_SLOTS-1)
+
+void kaelSched_init(KaelSched *sched){
+	if(NULL_CHECK(sched)){return;}
+	*sched = (KaelSched){0};
+	memset(sched->slotHead, KAEL_SCHED_NO_JOB, sizeof(sched->slotHead));
+	sched->lastClock = kaelClock_time();
+}
+
+
+
+
+//------ Private ------
+
+/**
+ * @brief Extend 16-bit clock to 64 bits. Must be called at least every KTIME_MAX ticks
+ */
+uint64_t _kaelSched_updateTime(KaelSched *sched){
+	ktime_t clockNow = kaelClock_time();
+	sched->now += (ktime_t)(clockNow - sched->lastClock);
+	sched->lastClock = clockNow;
+	return sched->now;
+}
+
+void _kaelSched_insert(KaelSched *sched, uint8_t jobIndex){
+	KaelSched_job *job = &sched->job[jobIndex];
+	if(job->release < sched->wheelTime + KAEL_SCHED_SLOT_LENGTH){
+		sched->ready |= 1U<<jobIndex; //due in current slot or late
+		return;
+	}
+
+	uint64_t slotsAhead = (job->release - sched->wheelTime) >> KAEL_SCHED_SLOT_SHIFT;
+	uint8_t slot = ((sched->wheelTime >> KAEL_SCHED_SLOT_SHIFT) + slotsAhead) & KAEL_SCHED_SLOT_MASK;
+	job->rounds = (slotsAhead-1) / KAEL_SCHED_SLOTS;
+
+	job->next = sched->slotHead[slot];
+	sched->slotHead[slot] = jobIndex;
+	sched->slotUsed |= 1ULL<<slot;
+}
+
+/**
+ * @brief Move cursor to current time, releasing jobs whose slot and round were reached
+ */
+void _kaelSched_advance(KaelSched *sched){
+	while(sched->wheelTime + KAEL_SCHED_SLOT_LENGTH <= sched->now){
+		sched->wheelTime += KAEL_SCHED_SLOT_LENGTH;
+		uint8_t slot = (sched->wheelTime >> KAEL_SCHED_SLOT_SHIFT) & KAEL_SCHED_SLOT_MASK;
+		if( !(sched->slotUsed & (1ULL<<slot)) ){
+			continue;
+		}
+
+		uint8_t jobIndex = sched->slotHead[slot];
+		uint8_t keep = KAEL_SCHED_NO_JOB;
+		while(jobIndex != KAEL_SCHED_NO_JOB){
+			KaelSched_job *job = &sched->job[jobIndex];
+			uint8_t next = job->next;
+			if(job->rounds > 0){
+				job->rounds--;
+				job->next = keep;
+				keep = jobIndex;
+			}else{
+				sched->ready |= 1U<<jobIndex;
+			}
+			jobIndex = next;
+		}
+
+		sched->slotHead[slot] = keep;
+		if(keep == KAEL_SCHED_NO_JOB){
+			sched->slotUsed &= ~(1ULL<<slot);
+		}
+	}
+}
+
+/**
+ * @brief Earliest deadline among released jobs that are due and not excluded
+ */
+uint8_t _kaelSched_pickEdf(KaelSched *sched, uint16_t exclude){
+	uint8_t best = KAEL_SCHED_NO_JOB;
+	uint64_t bestDeadline = UINT64_MAX;
+	uint16_t mask = sched->ready & ~exclude;
+
+	while(mask){
+		uint8_t i = __builtin_ctz(mask);
+		mask &= mask-1;
+		KaelSched_job *job = &sched->job[i];
+		uint64_t deadline = job->release + job->period;
+		if(job->release <= sched->now && deadline < bestDeadline){
+			best = i;
+			bestDeadline = deadline;
+		}
+	}
+	return best;
+}
+
+/**
+ * @brief Next time a critical job is released. UINT64_MAX if there are none
+ */
+uint64_t _kaelSched_nextCritical(const KaelSched *sched){
+	uint64_t next = UINT64_MAX;
+	for(uint8_t i=0; i<sched->jobCount; i++){
+		const KaelSched_job *job = &sched->job[i];
+		if(job->priority == KAEL_SCHED_CRITICAL && job->release < next){
+			next = job->release;
+		}
+	}
+	return next;
+}
+
+/**
+ * @brief Next time anything can change: a released job becomes due or an occupied slot is reached
+ */
+uint64_t _kaelSched_nextEvent(const KaelSched *sched){
+	uint64_t next = sched->wheelTime + KAEL_SCHED_SLOT_LENGTH*KAEL_SCHED_SLOTS;
+
+	if(sched->slotUsed){
+		//Rotate so bit 0 is the slot after cursor
+		uint8_t cursor = (sched->wheelTime >> KAEL_SCHED_SLOT_SHIFT) & KAEL_SCHED_SLOT_MASK;
+		uint8_t shift = (cursor+1) & KAEL_SCHED_SLOT_MASK;
+		uint64_t rotated = shift ? (sched->slotUsed >> shift) | (sched->slotUsed << (KAEL_SCHED_SLOTS-shift)) : sched->slotUsed;
+		next = sched->wheelTime + KAEL_SCHED_SLOT_LENGTH*(__builtin_ctzll(rotated)+1);
+	}
+
+	uint16_t mask = sched->ready;
+	while(mask){
+		uint8_t i = __builtin_ctz(mask);
+		mask &= mask-1;
+		if(sched->job[i].release > sched->now && sched->job[i].release < next){
+			next = sched->job[i].release;
+		}
+	}
+	return next;
+}
+
+/**
+ * @brief Release next instance. Low priority jobs skip instances that are already over
+ */
+void _kaelSched_reschedule(KaelSched *sched, uint8_t jobIndex){
+	KaelSched_job *job = &sched->job[jobIndex];
+	sched->ready &= ~(1U<<jobIndex);
+	job->release += job->period;
+
+	uint64_t behind = sched->now > job->release ? sched->now - job->release : 0;
+	uint32_t limit = job->priority==KAEL_SCHED_CRITICAL ? job->period*KAEL_SCHED_BACKLOG_MAX : job->period;
+	if(behind >= limit){
+		uint64_t skipped = behind / job->period;
+		job->stats.missed += skipped;
+		job->release += skipped*job->period;
+	}
+	_kaelSched_insert(sched, jobIndex);
+}
+
+void _kaelSched_runJob(KaelSched *sched, uint8_t jobIndex){
+	KaelSched_job *job = &sched->job[jobIndex];
+	uint64_t start = sched->now;
+	uint32_t lateness = start - job->release;
+	job->stats.maxLateness = lateness > job->stats.maxLateness ? lateness : job->stats.maxLateness;
+
+	job->func(job->state);
+
+	uint32_t cost = _kaelSched_updateTime(sched) - start;
+	job->stats.cost = cost > job->stats.cost ? cost : job->stats.cost - (job->stats.cost-cost)/8;
+	job->stats.runs++;
+}
+
+
+
+
+//------ Jobs ------
+
+/**
+ * @brief Add periodic job, first released now. Jobs are indexed in the order they are added
+ *
+ * @param period clock ticks between releases, e.g. AUDIO_BUFFER_SIZE for audio or TARGET_CLOCK_HZ/fps
+ * @return KAEL_SUCCESS, KAEL_ERR_FULL if all KAEL_SCHED_JOBS_MAX are taken
+ */
+uint8_t kaelSched_addJob(KaelSched *sched, KaelSched_jobFunc func, void *state, uint32_t period, uint8_t priority){
+	if(NULL_CHECK(sched) || func==NULL){return KAEL_ERR_NULL;}
+	if(sched->jobCount >= KAEL_SCHED_JOBS_MAX){
+		return KAEL_ERR_FULL;
+	}
+
+	uint8_t jobIndex = sched->jobCount;
+	sched->job[jobIndex] = (KaelSched_job){
+		.func = func,
+		.state = state,
+		.release = _kaelSched_updateTime(sched),
+		.period = period ? period : 1,
+		.priority = priority,
+		.next = KAEL_SCHED_NO_JOB,
+	};
+	sched->jobCount++;
+
+	_kaelSched_advance(sched);
+	_kaelSched_insert(sched, jobIndex);
+	return KAEL_SUCCESS;
+}
+
+/**
+ * @brief Change period, e.g. render fps. Takes effect from the next release
+ */
+uint8_t kaelSched_setPeriod(KaelSched *sched, uint8_t jobIndex, uint32_t period){
+	if(NULL_CHECK(sched)){return KAEL_ERR_NULL;}
+	if(jobIndex >= sched->jobCount){return KAEL_ERR_FULL;}
+	sched->job[jobIndex].period = period ? period : 1;
+	return KAEL_SUCCESS;
+}
+
+/**
+ * @brief Seed cost estimate so a long job isn't started in too little slack before it was measured
+ */
+uint8_t kaelSched_setCost(KaelSched *sched, uint8_t jobIndex, uint32_t cost){
+	if(NULL_CHECK(sched)){return KAEL_ERR_NULL;}
+	if(jobIndex >= sched->jobCount){return KAEL_ERR_FULL;}
+	sched->job[jobIndex].stats.cost = cost;
+	return KAEL_SUCCESS;
+}
+
+uint8_t kaelSched_getStats(const KaelSched *sched, uint8_t jobIndex, KaelSched_jobStats *stats){
+	if(NULL_CHECK(sched) || NULL_CHECK(stats)){return KAEL_ERR_NULL;}
+	if(jobIndex >= sched->jobCount){return KAEL_ERR_FULL;}
+	*stats = sched->job[jobIndex].stats;
+	return KAEL_SUCCESS;
+}
+
+
+
+
+//------ Running ------
+
+uint64_t kaelSched_getTime(KaelSched *sched){
+	if(NULL_CHECK(sched)){return 0;}
+	return _kaelSched_updateTime(sched);
+}
+
+/**
+ * @brief Run every released job that fits, then sleep until the next event
+ */
+void kaelSched_runOnce(KaelSched *sched){
+	if(NULL_CHECK(sched)){return;}
+	_kaelSched_updateTime(sched);
+	_kaelSched_advance(sched);
+
+	uint16_t deferred = 0; //low priority jobs that didn't fit during this pass
+	while(1){
+		uint8_t jobIndex = _kaelSched_pickEdf(sched, deferred);
+		if(jobIndex == KAEL_SCHED_NO_JOB){
+			break;
+		}
+		KaelSched_job *job = &sched->job[jobIndex];
+
+		if(job->priority != KAEL_SCHED_CRITICAL){
+			uint64_t nextCritical = _kaelSched_nextCritical(sched);
+			uint64_t slack = nextCritical > sched->now ? nextCritical - sched->now : 0;
+			if(job->stats.cost > slack){
+				if(sched->now >= job->release + job->period){
+					job->stats.missed++; //deadline passed while waiting
+					_kaelSched_reschedule(sched, jobIndex);
+				}else{
+					job->stats.deferred++;
+					deferred |= 1U<<jobIndex;
+				}
+				continue;
+			}
+		}
+
+		_kaelSched_runJob(sched, jobIndex);
+		_kaelSched_reschedule(sched, jobIndex);
+		_kaelSched_advance(sched);
+	}
+
+	uint64_t next = _kaelSched_nextEvent(sched);
+	if(next > sched->now){
+		uint64_t wait = next - sched->now;
+		kaelClock_sleep(wait < KTIME_MAX/2 ? wait : KTIME_MAX/2);
+	}
+}
+
+/**
+ * @brief Run until kaelSched_stop is called from a job
+ */
+void kaelSched_run(KaelSched *sched){
+	if(NULL_CHECK(sched)){return;}
+	sched->quit = 0;
+	while(!sched->quit){
+		kaelSched_runOnce(sched);
+	}
+}
+
+void kaelSched_stop(KaelSched *sched){
+	if(NULL_CHECK(sched)){return;}
+	sched->quit = 1;
+}
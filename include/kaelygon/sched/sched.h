@@ -0,0 +1,79 @@
+/**
+ * @file sched.h
+ *
+ * @brief Header, main loop scheduler. Timer wheel releases periodic jobs, earliest deadline runs first
+ *
+ * Critical jobs (audio) always run when released. Low priority jobs (render) run only if their measured cost
+ * fits in the slack before the next critical release, otherwise they are deferred and eventually skipped.
+ * Time is read through kaelClock_time, so the virtual clock variant makes schedules deterministic
+ */
+#pragma once
+
+#include <stdint.h>
+
+#include "kaelygon/global/kaelMacros.h"
+#include "kaelygon/clock/clock.h"
+
+#define KAEL_SCHED_JOBS_MAX 16U
+#define KAEL_SCHED_NO_JOB UINT8_MAX
+
+//Wheel slot is 2^SHIFT clock ticks, ~1ms at 32768 Hz. 64 slots span ~62ms, longer periods wait extra rounds
+#define KAEL_SCHED_SLOT_SHIFT 5U
+#define KAEL_SCHED_SLOTS 64U
+
+//Critical job further behind than this many periods drops the backlog
+#define KAEL_SCHED_BACKLOG_MAX 8U
+
+typedef void (*KaelSched_jobFunc)(void *state);
+
+typedef enum{
+	KAEL_SCHED_CRITICAL = 0, //never deferred
+	KAEL_SCHED_LOW, //runs in slack before next critical release
+}KaelSched_priority;
+
+typedef struct{
+	uint32_t runs;
+	uint32_t deferred; //times job didn't fit in slack and waited
+	uint32_t missed; //released instances skipped entirely
+	uint32_t cost; //decaying peak run time in clock ticks
+	uint32_t maxLateness; //longest delay from release to start in clock ticks
+}KaelSched_jobStats;
+
+typedef struct{
+	KaelSched_jobFunc func;
+	void *state; //owned by caller
+	uint64_t release; //time the current instance becomes runnable, deadline is release+period
+	uint32_t period; //clock ticks between releases
+	uint8_t priority; //KaelSched_priority
+	uint8_t next; //next job in the same wheel slot
+	uint16_t rounds; //wheel revolutions left before release
+	KaelSched_jobStats stats;
+}KaelSched_job;
+
+typedef struct{
+	KaelSched_job job[KAEL_SCHED_JOBS_MAX];
+	uint8_t jobCount;
+
+	uint8_t slotHead[KAEL_SCHED_SLOTS]; //first job in slot or KAEL_SCHED_NO_JOB
+	uint64_t slotUsed; //bit per non-empty slot
+	uint64_t wheelTime; //start of the slot at wheel cursor
+	uint16_t ready; //bit per released job waiting to run
+
+	uint64_t now; //64-bit extension of kaelClock_time
+	ktime_t lastClock;
+	uint8_t quit;
+}KaelSched;
+
+void kaelSched_init(KaelSched *sched);
+
+//------ Jobs ------
+uint8_t kaelSched_addJob(KaelSched *sched, KaelSched_jobFunc func, void *state, uint32_t period, uint8_t priority);
+uint8_t kaelSched_setPeriod(KaelSched *sched, uint8_t jobIndex, uint32_t period);
+uint8_t kaelSched_setCost(KaelSched *sched, uint8_t jobIndex, uint32_t cost);
+uint8_t kaelSched_getStats(const KaelSched *sched, uint8_t jobIndex, KaelSched_jobStats *stats);
+
+//------ Running ------
+uint64_t kaelSched_getTime(KaelSched *sched);
+void kaelSched_runOnce(KaelSched *sched);
+void kaelSched_run(KaelSched *sched);
+void kaelSched_stop(KaelSched *sched);
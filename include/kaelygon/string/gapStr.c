@@ -0,0 +1,248 @@
+/**
+ * @file gapStr.c
+ *
+ * @brief Implementation, gap buffer text for editing long strings at a cursor
+ *
+ * Gap always keeps at least one byte, so kaelGapStr_flatten can null terminate without allocating.
+ * Growth uses the same 3/2 factor as KaelTree and moves only the text after the cursor
+ */
+
+#include "kaelygon/string/gapStr.h"
+#include "kaelygon/math/math.h"
+#include "kaelygon/mem/mem.h"
+
+#define GAP_GROWTH_NUMER 3U
+#define GAP_GROWTH_DENOM 2U
+
+
+
+
+//------ Private ------
+
+uint16_t _kaelGapStr_gapLength(const KaelGapStr *gap){
+	return gap->gapEnd - gap->gapStart;
+}
+
+/**
+ * @brief Grow buffer so gap holds more than count bytes. Text after gap is moved to the new end
+ * @return Kael_infoCode
+ */
+uint8_t _kaelGapStr_grow(KaelGapStr *gap, uint16_t count){
+	uint32_t length = kaelGapStr_length(gap);
+	uint32_t need = length + count + 1U;
+	if(need > UINT16_MAX){
+		return KAEL_ERR_FULL;
+	}
+
+	uint32_t newCapacity = (uint32_t)gap->capacity * GAP_GROWTH_NUMER / GAP_GROWTH_DENOM;
+	newCapacity = newCapacity < need ? need : newCapacity;
+	newCapacity = newCapacity > UINT16_MAX ? UINT16_MAX : newCapacity;
+
+	uint8_t *newData = KAEL_REALLOC(KAEL_MEM_STRING, gap->data, newCapacity);
+	if(NULL_CHECK(newData)){return KAEL_ERR_ALLOC;}
+
+	uint16_t tailLength = gap->capacity - gap->gapEnd;
+	memmove(newData + newCapacity - tailLength, newData + gap->gapEnd, tailLength);
+
+	gap->data = newData;
+	gap->gapEnd = newCapacity - tailLength;
+	gap->capacity = newCapacity;
+	return KAEL_SUCCESS;
+}
+
+
+
+
+//------ Alloc / Free ------
+
+/**
+ * @brief Initialize empty text with room for capacity bytes before first growth
+ * @return Kael_infoCode
+ */
+uint8_t kaelGapStr_alloc(KaelGapStr *gap, uint16_t capacity){
+	if(NULL_CHECK(gap)){return KAEL_ERR_NULL;}
+	capacity = kaelMath_max(capacity, 1); //gap keeps a byte for null termination
+
+	gap->data = KAEL_MALLOC(KAEL_MEM_STRING, capacity);
+	if(NULL_CHECK(gap->data)){return KAEL_ERR_ALLOC;}
+	gap->capacity = capacity;
+	gap->gapStart = 0;
+	gap->gapEnd = capacity;
+	return KAEL_SUCCESS;
+}
+
+void kaelGapStr_free(KaelGapStr *gap){
+	if(NULL_CHECK(gap)){return;}
+	KAEL_FREE(gap->data);
+	*gap = (KaelGapStr){0};
+}
+
+
+
+
+//------ Edit at cursor ------
+
+/**
+ * @brief Move cursor to index, clamped to text length. Cost is the distance moved, not text length
+ * @return Kael_infoCode
+ */
+uint8_t kaelGapStr_setCursor(KaelGapStr *gap, uint16_t index){
+	if(NULL_CHECK(gap)){return KAEL_ERR_NULL;}
+	index = kaelMath_min(index, kaelGapStr_length(gap));
+
+	if(index < gap->gapStart){
+		uint16_t move = gap->gapStart - index;
+		memmove(gap->data + gap->gapEnd - move, gap->data + index, move);
+		gap->gapStart -= move;
+		gap->gapEnd -= move;
+	}else{
+		uint16_t move = index - gap->gapStart;
+		memmove(gap->data + gap->gapStart, gap->data + gap->gapEnd, move);
+		gap->gapStart += move;
+		gap->gapEnd += move;
+	}
+	return KAEL_SUCCESS;
+}
+
+/**
+ * @brief Insert count bytes at cursor, cursor ends up after them
+ * @return Kael_infoCode
+ */
+uint8_t kaelGapStr_insert(KaelGapStr *gap, const uint8_t *src, uint16_t count){
+	if(NULL_CHECK(gap) || NULL_CHECK(src)){return KAEL_ERR_NULL;}
+	if(count >= _kaelGapStr_gapLength(gap)){
+		uint8_t code = _kaelGapStr_grow(gap, count);
+		if(code!=KAEL_SUCCESS){return code;}
+	}
+	memcpy(gap->data + gap->gapStart, src, count);
+	gap->gapStart += count;
+	return KAEL_SUCCESS;
+}
+
+uint8_t kaelGapStr_insertCstr(KaelGapStr *gap, const char *src){
+	if(NULL_CHECK(src)){return KAEL_ERR_NULL;}
+	size_t length = strlen(src);
+	if(length > UINT16_MAX){return KAEL_ERR_FULL;}
+	return kaelGapStr_insert(gap, (const uint8_t *)src, (uint16_t)length);
+}
+
+/**
+ * @brief Erase up to count bytes before cursor, like backspace
+ * @return Number of bytes erased
+ */
+uint16_t kaelGapStr_erase(KaelGapStr *gap, uint16_t count){
+	if(NULL_CHECK(gap)){return 0;}
+	count = kaelMath_min(count, gap->gapStart);
+	gap->gapStart -= count;
+	return count;
+}
+
+/**
+ * @brief Erase up to count bytes after cursor, like delete
+ * @return Number of bytes erased
+ */
+uint16_t kaelGapStr_eraseForward(KaelGapStr *gap, uint16_t count){
+	if(NULL_CHECK(gap)){return 0;}
+	count = kaelMath_min(count, gap->capacity - gap->gapEnd);
+	gap->gapEnd += count;
+	return count;
+}
+
+
+
+
+//------ Read ------
+
+/**
+ * @brief Copy text range to dest and null terminate it, for drawing the visible part of the text
+ *
+ * @note dest has to hold count+1 bytes
+ * @return Number of bytes copied, clamped to text length
+ */
+uint16_t kaelGapStr_copyRange(const KaelGapStr *gap, uint8_t *dest, uint16_t index, uint16_t count){
+	if(NULL_CHECK(gap) || NULL_CHECK(dest)){return 0;}
+	uint16_t length = kaelGapStr_length(gap);
+	index = kaelMath_min(index, length);
+	count = kaelMath_min(count, length - index);
+
+	//Part before gap
+	uint16_t copied = 0;
+	if(index < gap->gapStart){
+		copied = kaelMath_min(count, gap->gapStart - index);
+		memcpy(dest, gap->data + index, copied);
+	}
+
+	//Part after gap
+	if(copied < count){
+		uint16_t afterIndex = index + copied + _kaelGapStr_gapLength(gap);
+		memcpy(dest + copied, gap->data + afterIndex, count - copied);
+	}
+
+	dest[count] = '\0';
+	return count;
+}
+
+/**
+ * @brief Find index where nth line starts, line 0 starts at 0
+ * @return Line start index or text length if text has fewer lines
+ */
+uint16_t kaelGapStr_lineStart(const KaelGapStr *gap, uint16_t line){
+	if(NULL_CHECK(gap)){return 0;}
+	if(line==0){return 0;}
+
+	//Scan both sides of the gap for line feeds
+	const uint8_t *part[2] = {gap->data, gap->data + gap->gapEnd};
+	uint16_t partLength[2] = {gap->gapStart, gap->capacity - gap->gapEnd};
+	uint16_t offset = 0;
+	for(uint8_t p=0; p<2; p++){
+		const uint8_t *read = part[p];
+		const uint8_t *end = part[p] + partLength[p];
+		while(read < end){
+			const uint8_t *found = memchr(read, '\n', end - read);
+			if(found==NULL){break;}
+			read = found + 1;
+			if(--line == 0){
+				return offset + (uint16_t)(read - part[p]);
+			}
+		}
+		offset += partLength[p];
+	}
+	return kaelGapStr_length(gap);
+}
+
+/**
+ * @brief Make text contiguous and null terminated by moving the cursor to the end
+ * @return Text address, valid until the next edit
+ */
+uint8_t *kaelGapStr_flatten(KaelGapStr *gap){
+	if(NULL_CHECK(gap)){return NULL;}
+	kaelGapStr_setCursor(gap, kaelGapStr_length(gap));
+	gap->data[gap->gapStart] = '\0';
+	return gap->data;
+}
+
+/**
+ * @brief Get byte at text index
+ *
+ * @warning No NULL_CHECK
+ */
+uint8_t kaelGapStr_get(const KaelGapStr *gap, uint16_t index){
+	KAEL_ASSERT(gap!=NULL);
+	KAEL_ASSERT(index < kaelGapStr_length(gap), "kaelGapStr_get out of bounds");
+	return index < gap->gapStart ? gap->data[index] : gap->data[index + _kaelGapStr_gapLength(gap)];
+}
+
+
+
+
+//------ Getters ------
+
+uint16_t kaelGapStr_length(const KaelGapStr *gap){
+	if(NULL_CHECK(gap)){return 0;}
+	return gap->capacity - _kaelGapStr_gapLength(gap);
+}
+
+uint16_t kaelGapStr_cursor(const KaelGapStr *gap){
+	if(NULL_CHECK(gap)){return 0;}
+	return gap->gapStart;
+}
@@ -0,0 +1,44 @@
+/**
+ * @file gapStr.h
+ *
+ * @brief Header, gap buffer text for editing long strings at a cursor
+ *
+ * Text is stored as [before cursor][gap][after cursor]. Insert and erase at the cursor only touch the gap,
+ * moving the cursor moves the bytes between old and new position. Keystroke cost stays flat as text grows
+ */
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "kaelygon/global/kaelMacros.h"
+
+typedef struct{
+	uint8_t *data;
+	uint16_t capacity; //allocated bytes, text length + gap
+	uint16_t gapStart; //cursor, first gap byte
+	uint16_t gapEnd; //first byte after gap
+}KaelGapStr;
+
+//------ Alloc / Free ------
+uint8_t kaelGapStr_alloc(KaelGapStr *gap, uint16_t capacity);
+void kaelGapStr_free(KaelGapStr *gap);
+
+//------ Edit at cursor ------
+uint8_t kaelGapStr_setCursor(KaelGapStr *gap, uint16_t index);
+uint8_t kaelGapStr_insert(KaelGapStr *gap, const uint8_t *src, uint16_t count);
+uint8_t kaelGapStr_insertCstr(KaelGapStr *gap, const char *src);
+uint16_t kaelGapStr_erase(KaelGapStr *gap, uint16_t count);
+uint16_t kaelGapStr_eraseForward(KaelGapStr *gap, uint16_t count);
+
+//------ Read ------
+uint16_t kaelGapStr_copyRange(const KaelGapStr *gap, uint8_t *dest, uint16_t index, uint16_t count);
+uint16_t kaelGapStr_lineStart(const KaelGapStr *gap, uint16_t line);
+uint8_t *kaelGapStr_flatten(KaelGapStr *gap);
+uint8_t kaelGapStr_get(const KaelGapStr *gap, uint16_t index);
+
+//------ Getters ------
+uint16_t kaelGapStr_length(const KaelGapStr *gap);
+uint16_t kaelGapStr_cursor(const KaelGapStr *gap);
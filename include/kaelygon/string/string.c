@@ -4,6 +4,8 @@
  * @brief Null terminated general purpose safer string
 */
 #include "kaelygon/string/string.h"
+#include "kaelygon/mem/arena.h"
+#include "kaelygon/mem/mem.h"
 
 uint8_t kaelStr_alloc(KaelStr *kstr, uint16_t bytes) {
 	if(NULL_CHECK(kstr)){
@@ -11,12 +13,31 @@ uint8_t kaelStr_alloc(KaelStr *kstr, uint16_t bytes) {
 	}
 	bytes = kaelMath_max(bytes,1); //minimum 1 byte allocation for null byte
 
-	kstr->s = (char *)malloc(bytes * sizeof(char));
+	kstr->s = (char *)KAEL_MALLOC(KAEL_MEM_STRING, bytes * sizeof(char));
 	if (NULL_CHECK(kstr->s)){
 		return KAEL_ERR_ALLOC;
 	}
 
 	kstr->size = bytes;
+	kstr->arena = NULL;
+	kaelStr_setEnd(kstr,0);
+	return KAEL_SUCCESS;
+}
+
+//Allocate string from arena, released by arena rollback or reset instead of kaelStr_free
+uint8_t kaelStr_allocArena(KaelStr *kstr, uint16_t bytes, KaelArena *arena) {
+	if(NULL_CHECK(kstr) || NULL_CHECK(arena)){
+		return KAEL_ERR_NULL;
+	}
+	bytes = kaelMath_max(bytes,1); //minimum 1 byte allocation for null byte
+
+	kstr->s = (char *)kaelArena_push(arena, bytes * sizeof(char));
+	if (NULL_CHECK(kstr->s)){
+		return KAEL_ERR_ALLOC;
+	}
+
+	kstr->size = bytes;
+	kstr->arena = arena;
 	kaelStr_setEnd(kstr,0);
 	return KAEL_SUCCESS;
 }
@@ -25,7 +46,9 @@ void kaelStr_free(KaelStr *kstr){
 	if(NULL_CHECK(kstr)){
 		return;
 	}
-	free(kstr->s);
+	if(kstr->arena==NULL){
+		KAEL_FREE(kstr->s);
+	}
 	kstr->s = NULL;
 }
 
@@ -33,7 +56,12 @@ uint8_t kaelStr_resize(KaelStr *kstr, const uint16_t bytes) {
 	if(NULL_CHECK(kstr) || NULL_CHECK(kstr->s)){
 		return KAEL_ERR_NULL;
 	}
-	char *tmpKstr = realloc(kstr->s, bytes * sizeof(char));
+	char *tmpKstr;
+	if(kstr->arena!=NULL){
+		tmpKstr = kaelArena_resize(kstr->arena, kstr->s, kstr->size, bytes * sizeof(char));
+	}else{
+		tmpKstr = KAEL_REALLOC(KAEL_MEM_STRING, kstr->s, bytes * sizeof(char));
+	}
 	if (NULL_CHECK(tmpKstr)){
 		return KAEL_ERR_ALLOC; 
 	}
@@ -11,14 +11,18 @@
 #include "kaelygon/math/math.h"
 #include "kaelygon/global/kaelMacros.h"
 
+typedef struct KaelArena KaelArena; //kaelygon/mem/arena.h, included by string.c as debug macros include this header
+
 typedef struct KaelStr {
 	char *s;
 	uint16_t size; //allocated bytes
 	uint16_t end; //null byte index
+	KaelArena *arena; //NULL for heap
 }KaelStr;
 
 
 uint8_t kaelStr_alloc(KaelStr *kstr, uint16_t bytes);
+uint8_t kaelStr_allocArena(KaelStr *kstr, uint16_t bytes, KaelArena *arena);
 void kaelStr_free(KaelStr *kstr);
 uint8_t kaelStr_resize(KaelStr *kstr, const uint16_t bytes);
 
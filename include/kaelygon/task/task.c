@@ -0,0 +1,51 @@
+/**
+ * @file task.c
+ *
+ * @brief Implementation, stackless coroutine state and time slices
+ *
+ * Budget is measured with kaelClock_time, so the slice is in the same 32768 Hz ticks as the main loop
+ */
+
+#include "kaelygon/task/task.h"
+
+void kaelTask_init(KaelTask *task){
+	if(NULL_CHECK(task)){return;}
+	task->line = 0;
+}
+
+/**
+ * @return 1 if task has yielded and not yet finished
+ */
+uint8_t kaelTask_isRunning(const KaelTask *task){
+	if(NULL_CHECK(task)){return 0;}
+	return task->line != 0;
+}
+
+
+
+
+//------ Budget ------
+
+/**
+ * @brief Start time slice of limit clock ticks
+ */
+void kaelTask_startBudget(KaelTask_budget *budget, ktime_t limit){
+	if(NULL_CHECK(budget)){return;}
+	budget->limit = limit;
+	budget->start = kaelClock_time();
+}
+
+void kaelTask_restartBudget(KaelTask_budget *budget){
+	if(NULL_CHECK(budget)){return;}
+	budget->start = kaelClock_time();
+}
+
+/**
+ * @brief Check if the slice is used up. Called in hot loops
+ *
+ * @warning No NULL_CHECK
+ */
+uint8_t kaelTask_overBudget(const KaelTask_budget *budget){
+	KAEL_ASSERT(budget!=NULL);
+	return (ktime_t)(kaelClock_time() - budget->start) >= budget->limit;
+}
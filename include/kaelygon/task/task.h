@@ -0,0 +1,72 @@
+/**
+ * @file task.h
+ *
+ * @brief Header, stackless coroutines for cooperative main loop work
+ *
+ * Protothread style. A task is a function that resumes from its last yield using a switch on the saved line.
+ * Task state is 2 bytes, no stack is kept, so local variables don't survive a yield. Keep them in the caller's struct
+ *
+ * uint8_t decodeStep(Decoder *dec){
+ * 	KAEL_TASK_BEGIN(&dec->task);
+ * 	kaelTask_startBudget(&dec->budget, KAEL_TASK_BUDGET_TICKS);
+ * 	for(dec->i=0; dec->i<dec->length; dec->i++){
+ * 		decodeRow(dec, dec->i);
+ * 		KAEL_TASK_YIELD_OVER_BUDGET(&dec->task, &dec->budget);
+ * 	}
+ * 	KAEL_TASK_END(&dec->task);
+ * }
+ */
+#pragma once
+
+#include <stdint.h>
+
+#include "kaelygon/global/kaelMacros.h"
+#include "kaelygon/clock/clock.h"
+
+//Default slice, 16 ticks ~0.5ms at 32768 Hz
+#define KAEL_TASK_BUDGET_TICKS 16U
+
+typedef enum{
+	KAEL_TASK_DONE = 0, //finished, next call starts over
+	KAEL_TASK_YIELDED, //call again to continue
+}KaelTask_status;
+
+typedef struct{
+	uint16_t line; //resume point, 0 = start
+}KaelTask;
+
+typedef struct{
+	ktime_t start;
+	ktime_t limit;
+}KaelTask_budget;
+
+//------ Coroutine macros ------
+
+#define KAEL_TASK_BEGIN(task) switch((task)->line){ case 0:
+
+//Return KAEL_TASK_YIELDED, the next call continues after this line
+#define KAEL_TASK_YIELD(task) \
+	do{ (task)->line = __LINE__; return KAEL_TASK_YIELDED; case __LINE__:; }while(0)
+
+//Yield until cond is true, checking it again on every call
+#define KAEL_TASK_WAIT_UNTIL(task, cond) \
+	do{ (task)->line = __LINE__; __attribute__((fallthrough)); case __LINE__: if(!(cond)){ return KAEL_TASK_YIELDED; } }while(0)
+
+//Yield only when the time slice is used up. The slice restarts after resuming
+#define KAEL_TASK_YIELD_OVER_BUDGET(task, budget) \
+	do{ \
+		if(kaelTask_overBudget(budget)){ \
+			(task)->line = __LINE__; return KAEL_TASK_YIELDED; case __LINE__:; \
+			kaelTask_restartBudget(budget); \
+		} \
+	}while(0)
+
+#define KAEL_TASK_END(task) } (task)->line = 0; return KAEL_TASK_DONE
+
+void kaelTask_init(KaelTask *task);
+uint8_t kaelTask_isRunning(const KaelTask *task);
+
+//------ Budget ------
+void kaelTask_startBudget(KaelTask_budget *budget, ktime_t limit);
+void kaelTask_restartBudget(KaelTask_budget *budget);
+uint8_t kaelTask_overBudget(const KaelTask_budget *budget);
@@ -0,0 +1,63 @@
+//./include/kaelygon/terminal/keyMap.c
+//Key sequence to function bindings, one KaelMap lookup per key press instead of comparing every binding
+
+#include "kaelygon/global/kaelMacros.h"
+#include "kaelygon/terminal/keyMap.h"
+
+#define KEYMAP_START_LENGTH 16U
+
+//Zero pad key sequence to map key width. Returns 0 if sequence doesn't fit
+uint8_t _kaelKeyMap_pack(uint8_t *dest, const uint8_t *key, const uint16_t length){
+	if(length==0 || length >= KAEL_KEY_BYTES){return 0;}
+	memset(dest, 0, KAEL_KEY_BYTES);
+	memcpy(dest, key, length);
+	return 1;
+}
+
+uint8_t kaelKeyMap_alloc(KaelMap *keyMap){
+	return kaelMap_alloc(keyMap, KAEL_KEY_BYTES, sizeof(KaelKey_func), KEYMAP_START_LENGTH);
+}
+
+void kaelKeyMap_free(KaelMap *keyMap){
+	kaelMap_free(keyMap);
+}
+
+/**
+ * @brief Bind null terminated key sequence from keyID.h to func, replaces earlier binding
+ * @return Kael_infoCode
+ */
+uint8_t kaelKeyMap_bind(KaelMap *keyMap, const uint8_t *key, KaelKey_func func){
+	if(NULL_CHECK(keyMap) || NULL_CHECK(key)){return KAEL_ERR_NULL;}
+	uint8_t packed[KAEL_KEY_BYTES];
+	if(!_kaelKeyMap_pack(packed, key, strlen((const char *)key))){
+		KAEL_ERROR_NOTE("Key sequence too long");
+		return KAEL_ERR_UNSUPPORTED;
+	}
+	if(kaelMap_set(keyMap, packed, &func)==NULL){return KAEL_ERR_FULL;}
+	return KAEL_SUCCESS;
+}
+
+/**
+ * @brief Find function bound to key press read by kaelTui_getKeyPressStr
+ * @return Bound function or NULL
+ */
+KaelKey_func kaelKeyMap_find(const KaelMap *keyMap, const KaelStr *keyStr){
+	if(NULL_CHECK(keyMap) || NULL_CHECK(keyStr)){return NULL;}
+	uint8_t packed[KAEL_KEY_BYTES];
+	if(!_kaelKeyMap_pack(packed, (const uint8_t *)kaelStr_getCharPtr(keyStr), kaelStr_getEnd(keyStr))){
+		return NULL;
+	}
+	KaelKey_func *func = kaelMap_get(keyMap, packed);
+	return func==NULL ? NULL : *func;
+}
+
+/**
+ * @brief Call function bound to key press with state
+ * @return 1 if a function was called
+ */
+uint8_t kaelKeyMap_call(const KaelMap *keyMap, const KaelStr *keyStr, void *state){
+	KaelKey_func func = kaelKeyMap_find(keyMap, keyStr);
+	if(func==NULL){return 0;}
+	func(state);
+	return 1;
+}
@@ -7,27 +7,18 @@
 #include <stdint.h>
 
 #include "kaelygon/terminal/keyID.h"
-/*
-void kaelTui_funcA_(){}
-void kaelTui_funcB_(){}
-void kaelTui_funcC_(){} 
-void kaelTui_funcD_(){} 
+#include "kaelygon/treeMem/map.h"
+#include "kaelygon/string/string.h"
 
-//function pointer type
-typedef void (*keyFunc_t)(void);
+//Key sequence bytes stored per binding, zero padded. Longest keyID.h sequence is 5 bytes
+#define KAEL_KEY_BYTES 8U
 
-//key function pair
-typedef struct {	
-	const uint8_t* key;
-	keyFunc_t func;
-} KeyFuncMap;
+//function pointer type, state is passed through from kaelKeyMap_call
+typedef void (*KaelKey_func)(void *state);
 
 //key combinations-function map. IDs from keyID.h
-const KeyFuncMap keyFunc[] = {
-	{ KEY_UP_ARROW, kaelTui_funcA_ },
-	{ KEY_DOWN_ARROW, kaelTui_funcB_ },
-	{ KEY_RIGHT_ARROW, kaelTui_funcC_ },
-	{ KEY_LEFT_ARROW, kaelTui_funcC_ }
-	//...
-};
-*/
\ No newline at end of file
+uint8_t kaelKeyMap_alloc(KaelMap *keyMap);
+void kaelKeyMap_free(KaelMap *keyMap);
+uint8_t kaelKeyMap_bind(KaelMap *keyMap, const uint8_t *key, KaelKey_func func);
+KaelKey_func kaelKeyMap_find(const KaelMap *keyMap, const KaelStr *keyStr);
+uint8_t kaelKeyMap_call(const KaelMap *keyMap, const KaelStr *keyStr, void *state);
@@ -0,0 +1,320 @@
+/**
+	@file bankTree.c
+
+	@brief Segmented KaelTree, elements are stored in a list of up to 64 KiB banks
+
+	Bank length in elements is the largest power of two that fits KAEL_BANK_TREE_BYTES,
+	so index is split with a shift and a mask instead of a divide.
+	The first bank grows by the same factor as KaelTree until it's full,
+	after that every bank is allocated at full size and never moves.
+	Only the short bank pointer list is reallocated, which keeps push amortized O(1)
+*/
+
+#include "kaelygon/global/kaelMacros.h"
+#include "kaelygon/treeMem/bankTree.h"
+#include "kaelygon/mem/mem.h"
+
+//Same growth factor as tree.c for the first bank and bank pointer list
+#define BANK_GROWTH_NUMER 3U
+#define BANK_GROWTH_DENOM 2U
+
+#define BANK_FIRST_MIN 16U //smallest first bank allocation in elements
+#define BANK_SLOTS_MIN 4U
+
+
+
+
+//------ Private ------
+
+uint8_t *_kaelBankTree_address(const KaelBankTree *tree, const uint32_t index){
+	return tree->bank[index >> tree->bankShift] + (index & tree->bankMask) * tree->width;
+}
+
+/**
+ * @brief Add one full size bank to the end of bank list
+ * @return Kael_infoCode
+ */
+uint8_t _kaelBankTree_addBank(KaelBankTree *tree){
+	if(tree->bankCount == UINT16_MAX){
+		return KAEL_ERR_FULL;
+	}
+
+	if(tree->bankCount == tree->bankSlots){
+		uint32_t newSlots = (uint32_t)tree->bankSlots * BANK_GROWTH_NUMER / BANK_GROWTH_DENOM + 1U;
+		newSlots = newSlots > UINT16_MAX ? UINT16_MAX : newSlots;
+		uint8_t **newList = KAEL_REALLOC(KAEL_MEM_TREE, tree->bank, newSlots * sizeof(uint8_t *));
+		if(NULL_CHECK(newList)){return KAEL_ERR_ALLOC;}
+		tree->bank = newList;
+		tree->bankSlots = newSlots;
+	}
+
+	uint32_t bankLength = tree->bankMask + 1U;
+	uint8_t *newBank = KAEL_MALLOC(KAEL_MEM_TREE, (size_t)bankLength * tree->width);
+	if(NULL_CHECK(newBank)){return KAEL_ERR_ALLOC;}
+
+	tree->bank[tree->bankCount] = newBank;
+	tree->bankCount++;
+	tree->capacity += bankLength;
+	return KAEL_SUCCESS;
+}
+
+/**
+ * @brief Grow first bank or add banks until capacity fits need elements
+ * @return Kael_infoCode
+ */
+uint8_t _kaelBankTree_grow(KaelBankTree *tree, const uint32_t need){
+	uint32_t bankLength = tree->bankMask + 1U;
+	if((uint64_t)need > (uint64_t)bankLength * UINT16_MAX){
+		return KAEL_ERR_FULL;
+	}
+
+	while(tree->capacity < need){
+		if(tree->bankCount == 1 && tree->capacity < bankLength){
+			//Grow first bank in place until it's full size
+			uint64_t newCapacity = (uint64_t)tree->capacity * BANK_GROWTH_NUMER / BANK_GROWTH_DENOM;
+			newCapacity = newCapacity < need ? need : newCapacity;
+			newCapacity = newCapacity < BANK_FIRST_MIN ? BANK_FIRST_MIN : newCapacity;
+			newCapacity = newCapacity > bankLength ? bankLength : newCapacity;
+
+			uint8_t *newBank = KAEL_REALLOC(KAEL_MEM_TREE, tree->bank[0], (size_t)newCapacity * tree->width);
+			if(NULL_CHECK(newBank)){return KAEL_ERR_ALLOC;}
+			tree->bank[0] = newBank;
+			tree->capacity = newCapacity;
+			continue;
+		}
+
+		uint8_t code = _kaelBankTree_addBank(tree);
+		if(code!=KAEL_SUCCESS){return code;}
+	}
+	return KAEL_SUCCESS;
+}
+
+
+
+
+//------ Alloc and free ------
+
+/**
+ * @brief Initialize tree and allocate a small first bank
+ * @return Kael_infoCode
+ */
+uint8_t kaelBankTree_alloc(KaelBankTree *tree, const uint16_t width){
+	if(NULL_CHECK(tree)){return KAEL_ERR_NULL;}
+	*tree = (KaelBankTree){0};
+	tree->width = width==0 ? 1 : width;
+
+	//Largest power of two elements that fits in one bank
+	uint8_t shift = 0;
+	while( ((uint32_t)2 << shift) * tree->width <= KAEL_BANK_TREE_BYTES ){
+		shift++;
+	}
+	tree->bankShift = shift;
+	tree->bankMask = ((uint32_t)1 << shift) - 1U;
+
+	//First bank starts small and grows until it's full size
+	uint32_t firstLength = BANK_FIRST_MIN < tree->bankMask+1U ? BANK_FIRST_MIN : tree->bankMask+1U;
+	tree->bank = KAEL_MALLOC(KAEL_MEM_TREE, BANK_SLOTS_MIN * sizeof(uint8_t *));
+	if(NULL_CHECK(tree->bank)){return KAEL_ERR_ALLOC;}
+	tree->bankSlots = BANK_SLOTS_MIN;
+	tree->bank[0] = KAEL_MALLOC(KAEL_MEM_TREE, (size_t)firstLength * tree->width);
+	if(NULL_CHECK(tree->bank[0])){
+		KAEL_FREE(tree->bank);
+		*tree = (KaelBankTree){0};
+		return KAEL_ERR_ALLOC;
+	}
+	tree->bankCount = 1;
+	tree->capacity = firstLength;
+	return KAEL_SUCCESS;
+}
+
+/**
+ * @brief Free all banks
+ *
+ * @note Make sure to free allocated elements in tree
+ */
+void kaelBankTree_free(KaelBankTree *tree){
+	if(NULL_CHECK(tree) || NULL_CHECK(tree->bank)){return;}
+	for(uint16_t i=0; i<tree->bankCount; i++){
+		KAEL_FREE(tree->bank[i]);
+	}
+	KAEL_FREE(tree->bank);
+	*tree = (KaelBankTree){0};
+}
+
+/**
+ * @brief Allocate room for at least length elements without changing length
+ * @return Kael_infoCode
+ */
+uint8_t kaelBankTree_reserve(KaelBankTree *tree, const uint32_t length){
+	if(NULL_CHECK(tree)){return KAEL_ERR_NULL;}
+	return _kaelBankTree_grow(tree, length);
+}
+
+
+
+
+//------ Manipulate elements ------
+
+/**
+ * @brief Add element to tree. NULL element is initialized as zero
+ * @return On success return newly pushed element address. On fail return NULL
+ */
+void *kaelBankTree_push(KaelBankTree *tree, const void *restrict element){
+	if(NULL_CHECK(tree)){return NULL;}
+	if(tree->length == tree->capacity){
+		if(tree->length == UINT32_MAX || _kaelBankTree_grow(tree, tree->length+1U) != KAEL_SUCCESS){
+			return NULL;
+		}
+	}
+
+	uint8_t *dest = _kaelBankTree_address(tree, tree->length);
+	if(element==NULL){
+		memset(dest, 0, tree->width);
+	}else{
+		memcpy(dest, element, tree->width);
+	}
+	tree->length++;
+	return dest;
+}
+
+/**
+ * @brief Add count elements, copied one bank at a time. NULL elements are initialized as zero
+ * @return On success return address of the first new element. On fail return NULL
+ */
+void *kaelBankTree_pushN(KaelBankTree *tree, const void *restrict elements, const uint32_t count){
+	if(NULL_CHECK(tree)){return NULL;}
+	if(count==0 || count > UINT32_MAX - tree->length){return NULL;}
+	if(_kaelBankTree_grow(tree, tree->length+count) != KAEL_SUCCESS){return NULL;}
+
+	void *first = _kaelBankTree_address(tree, tree->length);
+	const uint8_t *src = elements;
+	uint32_t remaining = count;
+
+	while(remaining > 0){
+		uint32_t offset = tree->length & tree->bankMask;
+		uint32_t chunk = tree->bankMask + 1U - offset;
+		chunk = chunk < remaining ? chunk : remaining;
+
+		uint8_t *dest = _kaelBankTree_address(tree, tree->length);
+		if(src==NULL){
+			memset(dest, 0, (size_t)chunk * tree->width);
+		}else{
+			memcpy(dest, src, (size_t)chunk * tree->width);
+			src += (size_t)chunk * tree->width;
+		}
+		tree->length += chunk;
+		remaining -= chunk;
+	}
+	return first;
+}
+
+/**
+ * @brief Make contiguous room after the last element without changing length. Room ends at bank end
+ *
+ * Write up to spanLength elements through the returned span, then kaelBankTree_commitSpan the number written
+ * @param spanLength set to number of elements available in span, at most count
+ * @return On success return address right after the last element. On fail return NULL
+ */
+void *kaelBankTree_reserveSpan(KaelBankTree *tree, const uint32_t count, uint32_t *spanLength){
+	if(NULL_CHECK(tree) || NULL_CHECK(spanLength)){return NULL;}
+	*spanLength = 0;
+	if(count==0 || tree->length == UINT32_MAX){return NULL;}
+
+	uint32_t bankRoom = tree->bankMask + 1U - (tree->length & tree->bankMask);
+	uint32_t room = count < bankRoom ? count : bankRoom;
+	room = room < UINT32_MAX - tree->length ? room : UINT32_MAX - tree->length;
+	if(_kaelBankTree_grow(tree, tree->length+room) != KAEL_SUCCESS){return NULL;}
+
+	*spanLength = room;
+	return _kaelBankTree_address(tree, tree->length);
+}
+
+/**
+ * @brief Add count elements written through kaelBankTree_reserveSpan
+ *
+ * @warning No NULL_CHECK. count must not exceed the reserved span
+ */
+void kaelBankTree_commitSpan(KaelBankTree *tree, const uint32_t count){
+	KAEL_ASSERT(tree!=NULL);
+	KAEL_ASSERT(count <= tree->capacity - tree->length, "kaelBankTree_commitSpan beyond reserved span");
+	tree->length += count;
+}
+
+/**
+ * @brief Remove last element. Banks are kept allocated
+ * @return Kael_infoCode
+ */
+uint8_t kaelBankTree_pop(KaelBankTree *tree){
+	if(NULL_CHECK(tree) || tree->length==0){return KAEL_ERR_NULL;}
+	tree->length--;
+	return KAEL_SUCCESS;
+}
+
+
+
+
+//------ Getters ------
+
+/**
+ * @brief Get element by index
+ *
+ * @warning No NULL_CHECK
+ */
+void *kaelBankTree_get(const KaelBankTree *tree, const uint32_t index){
+	KAEL_ASSERT(tree!=NULL);
+	KAEL_ASSERT(index < tree->length, "kaelBankTree_get out of bounds");
+	return _kaelBankTree_address(tree, index);
+}
+
+/**
+ * @brief Get first element of a bank for contiguous iteration
+ * @param count set to number of elements in use in the bank
+ * @return Bank address or NULL if bank holds no elements
+ */
+void *kaelBankTree_getBank(const KaelBankTree *tree, const uint16_t bankIndex, uint32_t *count){
+	if(NULL_CHECK(tree) || NULL_CHECK(count)){return NULL;}
+	uint64_t start = (uint64_t)bankIndex << tree->bankShift;
+	if(bankIndex >= tree->bankCount || start >= tree->length){
+		*count = 0;
+		return NULL;
+	}
+	uint32_t used = tree->length - (uint32_t)start;
+	*count = used < tree->bankMask+1U ? used : tree->bankMask+1U;
+	return tree->bank[bankIndex];
+}
+
+uint32_t kaelBankTree_length(const KaelBankTree *tree){
+	if(NULL_CHECK(tree)){return 0;}
+	return tree->length;
+}
+
+//Elements per full bank
+uint32_t kaelBankTree_bankLength(const KaelBankTree *tree){
+	if(NULL_CHECK(tree)){return 0;}
+	return tree->bankMask + 1U;
+}
+
+/**
+ * @brief Copy count elements starting from index to flat dest
+ * @return Number of elements copied, clamped to tree length
+ */
+uint32_t kaelBankTree_copyOut(const KaelBankTree *tree, void *dest, const uint32_t index, const uint32_t count){
+	if(NULL_CHECK(tree) || NULL_CHECK(dest)){return 0;}
+	if(index >= tree->length){return 0;}
+
+	uint32_t total = tree->length - index;
+	total = total < count ? total : count;
+
+	uint8_t *out = dest;
+	uint32_t pos = index;
+	uint32_t remaining = total;
+	while(remaining > 0){
+		uint32_t chunk = tree->bankMask + 1U - (pos & tree->bankMask);
+		chunk = chunk < remaining ? chunk : remaining;
+		memcpy(out, _kaelBankTree_address(tree, pos), (size_t)chunk * tree->width);
+		out += (size_t)chunk * tree->width;
+		pos += chunk;
+		remaining -= chunk;
+	}
+	return total;
+}
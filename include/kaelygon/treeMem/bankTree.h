@@ -0,0 +1,47 @@
+/**
+ * @file bankTree.h
+ * @brief Segmented KaelTree built from a list of 16-bit banks, holds more than 64 KiB
+ *
+ * Element index is split into bank and offset by shift and mask, so push and get stay O(1).
+ * Elements never straddle a bank. Addresses are stable once the first bank is full
+ */
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+//One bank covers a full 16-bit address range
+#define KAEL_BANK_TREE_BYTES (UINT16_MAX+1U)
+
+typedef struct{
+	uint8_t **bank; //bank pointers, every bank except the first holds bankLength elements
+	uint16_t bankCount; //allocated banks
+	uint16_t bankSlots; //length of bank pointer list
+	uint16_t width; //one element byte width
+	uint8_t bankShift; //log2 of bankLength
+	uint32_t bankMask; //bankLength-1
+	uint32_t length; //number of elements
+	uint32_t capacity; //allocated elements over all banks
+}KaelBankTree;
+
+uint8_t kaelBankTree_alloc(KaelBankTree *tree, const uint16_t width);
+void kaelBankTree_free(KaelBankTree *tree);
+uint8_t kaelBankTree_reserve(KaelBankTree *tree, const uint32_t length);
+
+//Manipulate elements
+void *kaelBankTree_push(KaelBankTree *tree, const void *restrict element);
+void *kaelBankTree_pushN(KaelBankTree *tree, const void *restrict elements, const uint32_t count);
+void *kaelBankTree_reserveSpan(KaelBankTree *tree, const uint32_t count, uint32_t *spanLength);
+void kaelBankTree_commitSpan(KaelBankTree *tree, const uint32_t count);
+uint8_t kaelBankTree_pop(KaelBankTree *tree);
+
+//Get ptr
+void *kaelBankTree_get(const KaelBankTree *tree, const uint32_t index);
+void *kaelBankTree_getBank(const KaelBankTree *tree, const uint16_t bankIndex, uint32_t *count);
+
+//Get value
+uint32_t kaelBankTree_length(const KaelBankTree *tree);
+uint32_t kaelBankTree_bankLength(const KaelBankTree *tree);
+uint32_t kaelBankTree_copyOut(const KaelBankTree *tree, void *dest, const uint32_t index, const uint32_t count);
@@ -0,0 +1,303 @@
+/**
+	@file deque.c
+
+	@brief Chunked deque, elements are stored in fixed size chunks that are never reallocated
+
+	Element position counts from the start of the chunk map, so the chunk is position>>chunkShift
+	and the element within it is position&chunkMask.
+	When either end of the map runs out, the used chunk pointers are recentered in a map that is
+	grown only if more than half of it is used. Chunk emptied by a pop is freed, one is kept as a spare
+	so pushing and popping across a chunk edge doesn't allocate every time
+*/
+
+#include "kaelygon/global/kaelMacros.h"
+#include "kaelygon/treeMem/deque.h"
+#include "kaelygon/mem/mem.h"
+
+//Same growth factor as tree.c
+#define DEQUE_GROWTH_NUMER 3U
+#define DEQUE_GROWTH_DENOM 2U
+
+#define DEQUE_MAP_MIN 8U
+
+
+
+
+//------ Private ------
+
+uint8_t *_kaelDeque_address(const KaelDeque *deque, const uint32_t position){
+	return deque->chunk[position >> deque->chunkShift] + (position & deque->chunkMask) * deque->width;
+}
+
+/**
+ * @brief Move used chunk pointers to the middle of the map, grow map if more than half is used
+ * @return Kael_infoCode
+ */
+uint8_t _kaelDeque_remap(KaelDeque *deque){
+	uint32_t usedFirst = deque->start >> deque->chunkShift;
+	uint32_t usedCount = 0;
+	if(deque->length){
+		usedCount = ((deque->start + deque->length - 1) >> deque->chunkShift) - usedFirst + 1;
+	}
+
+	uint32_t newSlots = deque->mapSlots;
+	if(usedCount*2 + 2 > newSlots){
+		newSlots = newSlots * DEQUE_GROWTH_NUMER / DEQUE_GROWTH_DENOM + 2;
+		newSlots = newSlots > UINT16_MAX ? UINT16_MAX : newSlots;
+		if(usedCount + 2 > newSlots){
+			return KAEL_ERR_FULL;
+		}
+	}
+
+	uint8_t **newMap = KAEL_CALLOC(KAEL_MEM_TREE, newSlots, sizeof(uint8_t *));
+	if(NULL_CHECK(newMap)){return KAEL_ERR_ALLOC;}
+
+	uint32_t newFirst = (newSlots - usedCount) / 2;
+	memcpy(newMap + newFirst, deque->chunk + usedFirst, usedCount * sizeof(uint8_t *));
+	KAEL_FREE(deque->chunk);
+
+	deque->chunk = newMap;
+	deque->mapSlots = newSlots;
+	deque->start = (newFirst << deque->chunkShift) + (deque->start & deque->chunkMask);
+	return KAEL_SUCCESS;
+}
+
+/**
+ * @brief Make sure chunk at map index exists, reuse spare chunk if any
+ * @return Kael_infoCode
+ */
+uint8_t _kaelDeque_fillChunk(KaelDeque *deque, const uint32_t chunkIndex){
+	if(deque->chunk[chunkIndex] != NULL){
+		return KAEL_SUCCESS;
+	}
+	if(deque->spare != NULL){
+		deque->chunk[chunkIndex] = deque->spare;
+		deque->spare = NULL;
+		return KAEL_SUCCESS;
+	}
+	deque->chunk[chunkIndex] = KAEL_MALLOC(KAEL_MEM_TREE, ((size_t)deque->chunkMask + 1U) * deque->width);
+	if(NULL_CHECK(deque->chunk[chunkIndex])){return KAEL_ERR_ALLOC;}
+	return KAEL_SUCCESS;
+}
+
+/**
+ * @brief Release chunk that no longer holds elements. First one is kept as spare
+ */
+void _kaelDeque_releaseChunk(KaelDeque *deque, const uint32_t chunkIndex){
+	if(deque->spare == NULL){
+		deque->spare = deque->chunk[chunkIndex];
+	}else{
+		KAEL_FREE(deque->chunk[chunkIndex]);
+	}
+	deque->chunk[chunkIndex] = NULL;
+}
+
+//Place empty deque in the middle of the map so both ends have room
+void _kaelDeque_recenter(KaelDeque *deque){
+	deque->start = (uint32_t)(deque->mapSlots / 2) << deque->chunkShift;
+}
+
+
+
+
+//------ Alloc and free ------
+
+/**
+ * @brief Initialize deque and allocate chunk map. Chunks are allocated on push
+ * @return Kael_infoCode
+ */
+uint8_t kaelDeque_alloc(KaelDeque *deque, const uint16_t width){
+	if(NULL_CHECK(deque)){return KAEL_ERR_NULL;}
+	*deque = (KaelDeque){0};
+	deque->width = width==0 ? 1 : width;
+
+	//Largest power of two elements that fits in one chunk
+	uint8_t shift = 0;
+	while( ((uint32_t)2 << shift) * deque->width <= KAEL_DEQUE_CHUNK_BYTES ){
+		shift++;
+	}
+	deque->chunkShift = shift;
+	deque->chunkMask = ((uint32_t)1 << shift) - 1U;
+
+	deque->chunk = KAEL_CALLOC(KAEL_MEM_TREE, DEQUE_MAP_MIN, sizeof(uint8_t *));
+	if(NULL_CHECK(deque->chunk)){return KAEL_ERR_ALLOC;}
+	deque->mapSlots = DEQUE_MAP_MIN;
+	_kaelDeque_recenter(deque);
+	return KAEL_SUCCESS;
+}
+
+/**
+ * @brief Free chunks and chunk map
+ *
+ * @note Make sure to free allocated elements in deque
+ */
+void kaelDeque_free(KaelDeque *deque){
+	if(NULL_CHECK(deque) || NULL_CHECK(deque->chunk)){return;}
+	for(uint16_t i=0; i<deque->mapSlots; i++){
+		KAEL_FREE(deque->chunk[i]);
+	}
+	KAEL_FREE(deque->spare);
+	KAEL_FREE(deque->chunk);
+	*deque = (KaelDeque){0};
+}
+
+/**
+ * @brief Remove all elements. Map and one spare chunk are kept
+ */
+void kaelDeque_clear(KaelDeque *deque){
+	if(NULL_CHECK(deque)){return;}
+	for(uint16_t i=0; i<deque->mapSlots; i++){
+		if(deque->chunk[i] != NULL){
+			_kaelDeque_releaseChunk(deque, i);
+		}
+	}
+	deque->length = 0;
+	_kaelDeque_recenter(deque);
+}
+
+
+
+
+//------ Manipulate elements ------
+
+/**
+ * @brief Add element after the last one. NULL element is initialized as zero
+ * @return On success return newly pushed element address. On fail return NULL
+ */
+void *kaelDeque_pushBack(KaelDeque *deque, const void *restrict element){
+	if(NULL_CHECK(deque)){return NULL;}
+	if(deque->length == UINT32_MAX){return NULL;}
+
+	uint32_t position = deque->start + deque->length;
+	if((position >> deque->chunkShift) >= deque->mapSlots){
+		if(_kaelDeque_remap(deque) != KAEL_SUCCESS){return NULL;}
+		position = deque->start + deque->length;
+	}
+	if(_kaelDeque_fillChunk(deque, position >> deque->chunkShift) != KAEL_SUCCESS){return NULL;}
+
+	uint8_t *dest = _kaelDeque_address(deque, position);
+	if(element==NULL){
+		memset(dest, 0, deque->width);
+	}else{
+		memcpy(dest, element, deque->width);
+	}
+	deque->length++;
+	return dest;
+}
+
+/**
+ * @brief Add element before the first one. NULL element is initialized as zero
+ * @return On success return newly pushed element address. On fail return NULL
+ */
+void *kaelDeque_pushFront(KaelDeque *deque, const void *restrict element){
+	if(NULL_CHECK(deque)){return NULL;}
+	if(deque->length == UINT32_MAX){return NULL;}
+
+	if(deque->start == 0){
+		if(_kaelDeque_remap(deque) != KAEL_SUCCESS){return NULL;}
+	}
+	uint32_t position = deque->start - 1;
+	if(_kaelDeque_fillChunk(deque, position >> deque->chunkShift) != KAEL_SUCCESS){return NULL;}
+
+	uint8_t *dest = _kaelDeque_address(deque, position);
+	if(element==NULL){
+		memset(dest, 0, deque->width);
+	}else{
+		memcpy(dest, element, deque->width);
+	}
+	deque->start--;
+	deque->length++;
+	return dest;
+}
+
+/**
+ * @brief Remove last element
+ * @return Kael_infoCode
+ */
+uint8_t kaelDeque_popBack(KaelDeque *deque){
+	if(NULL_CHECK(deque) || deque->length==0){return KAEL_ERR_NULL;}
+	uint32_t chunkIndex = (deque->start + deque->length - 1) >> deque->chunkShift;
+	deque->length--;
+
+	if(deque->length==0){
+		_kaelDeque_releaseChunk(deque, chunkIndex);
+		_kaelDeque_recenter(deque);
+	}else
+	if(((deque->start + deque->length - 1) >> deque->chunkShift) != chunkIndex){
+		_kaelDeque_releaseChunk(deque, chunkIndex);
+	}
+	return KAEL_SUCCESS;
+}
+
+/**
+ * @brief Remove first element
+ * @return Kael_infoCode
+ */
+uint8_t kaelDeque_popFront(KaelDeque *deque){
+	if(NULL_CHECK(deque) || deque->length==0){return KAEL_ERR_NULL;}
+	uint32_t chunkIndex = deque->start >> deque->chunkShift;
+	deque->start++;
+	deque->length--;
+
+	if(deque->length==0){
+		_kaelDeque_releaseChunk(deque, chunkIndex);
+		_kaelDeque_recenter(deque);
+	}else
+	if((deque->start >> deque->chunkShift) != chunkIndex){
+		_kaelDeque_releaseChunk(deque, chunkIndex);
+	}
+	return KAEL_SUCCESS;
+}
+
+
+
+
+//------ Getters ------
+
+/**
+ * @brief Get element by index from the front
+ *
+ * @warning No NULL_CHECK
+ */
+void *kaelDeque_get(const KaelDeque *deque, const uint32_t index){
+	KAEL_ASSERT(deque!=NULL);
+	KAEL_ASSERT(index < deque->length, "kaelDeque_get out of bounds");
+	return _kaelDeque_address(deque, deque->start + index);
+}
+
+/**
+ * @brief Get contiguous run of elements starting from index, it ends at chunk end or last element
+ * @param count set to number of elements in the run
+ *
+ * @warning No NULL_CHECK
+ */
+void *kaelDeque_getSpan(const KaelDeque *deque, const uint32_t index, uint32_t *count){
+	KAEL_ASSERT(deque!=NULL && count!=NULL);
+	KAEL_ASSERT(index < deque->length, "kaelDeque_getSpan out of bounds");
+	uint32_t position = deque->start + index;
+	uint32_t chunkRoom = deque->chunkMask + 1U - (position & deque->chunkMask);
+	uint32_t remaining = deque->length - index;
+	*count = chunkRoom < remaining ? chunkRoom : remaining;
+	return _kaelDeque_address(deque, position);
+}
+
+//get first element
+void *kaelDeque_front(const KaelDeque *deque){
+	return kaelDeque_get(deque, 0);
+}
+
+//get last element
+void *kaelDeque_back(const KaelDeque *deque){
+	return kaelDeque_get(deque, deque->length-1);
+}
+
+uint32_t kaelDeque_length(const KaelDeque *deque){
+	if(NULL_CHECK(deque)){return 0;}
+	return deque->length;
+}
+
+//@return 1 if NULL or empty. Return 0 if not empty
+uint8_t kaelDeque_empty(const KaelDeque *deque){
+	if(NULL_CHECK(deque)){return 1;}
+	return deque->length==0;
+}
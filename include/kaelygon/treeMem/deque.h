@@ -0,0 +1,47 @@
+/**
+ * @file deque.h
+ * @brief Chunked c++ std::deque like container. Element addresses never move
+ *
+ * Elements live in fixed size chunks listed in a map of chunk pointers.
+ * Push and pop are O(1) at both ends and growth only copies the map, never the elements
+ */
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+//Chunk byte size. Chunk holds the largest power of two elements that fits, at least one
+#define KAEL_DEQUE_CHUNK_BYTES 1024U
+
+typedef struct{
+	uint8_t **chunk; //map of chunk pointers, NULL where no element lives
+	uint8_t *spare; //emptied chunk kept for the next push
+	uint16_t mapSlots; //length of chunk map
+	uint16_t width; //one element byte width
+	uint8_t chunkShift; //log2 of elements per chunk
+	uint16_t chunkMask; //elements per chunk -1
+	uint32_t start; //map position of the first element
+	uint32_t length; //number of elements
+}KaelDeque;
+
+uint8_t kaelDeque_alloc(KaelDeque *deque, const uint16_t width);
+void kaelDeque_free(KaelDeque *deque);
+void kaelDeque_clear(KaelDeque *deque);
+
+//Manipulate elements
+void *kaelDeque_pushBack(KaelDeque *deque, const void *restrict element);
+void *kaelDeque_pushFront(KaelDeque *deque, const void *restrict element);
+uint8_t kaelDeque_popBack(KaelDeque *deque);
+uint8_t kaelDeque_popFront(KaelDeque *deque);
+
+//Get ptr
+void *kaelDeque_get(const KaelDeque *deque, const uint32_t index);
+void *kaelDeque_getSpan(const KaelDeque *deque, const uint32_t index, uint32_t *count);
+void *kaelDeque_front(const KaelDeque *deque);
+void *kaelDeque_back(const KaelDeque *deque);
+
+//Get value
+uint32_t kaelDeque_length(const KaelDeque *deque);
+uint8_t kaelDeque_empty(const KaelDeque *deque);
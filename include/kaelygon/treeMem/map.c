@@ -0,0 +1,295 @@
+/**
+	@file map.c
+
+	@brief Robin Hood hash map, keys are hashed with FNV-1a and probed linearly from their home slot
+
+	Insert takes the slot from any key that sits closer to its home than the carried key and carries
+	that key onwards, so probe distances stay short and even. Lookup stops as soon as it meets a key closer
+	to home than the searched key would be. Remove shifts the following keys back by one instead of leaving
+	tombstones. Two spare slots after the table are swap space for insert
+*/
+
+#include "kaelygon/global/kaelMacros.h"
+#include "kaelygon/treeMem/map.h"
+#include "kaelygon/mem/mem.h"
+
+#define MAP_SLOTS_MIN 8U
+
+//Grow when more than 7/8 of the slots are used
+#define MAP_LOAD_NUMER 7U
+#define MAP_LOAD_DENOM 8U
+
+#define MAP_FNV_OFFSET 2166136261U
+#define MAP_FNV_PRIME 16777619U
+
+
+
+
+//------ Private ------
+
+uint16_t _kaelMap_home(const KaelMap *map, const uint8_t *key){
+	uint32_t hash = MAP_FNV_OFFSET;
+	for(uint16_t i=0; i<map->keyWidth; i++){
+		hash ^= key[i];
+		hash *= MAP_FNV_PRIME;
+	}
+	hash ^= hash >> 16; //low bits pick the slot, fold the better mixed high bits in
+	return (uint16_t)(hash & (map->capacity - 1U));
+}
+
+uint8_t *_kaelMap_slot(const KaelMap *map, const uint16_t index){
+	return map->slot + (size_t)index * map->stride;
+}
+
+uint16_t _kaelMap_fitLength(const uint16_t capacity){
+	return (uint16_t)((uint32_t)capacity * MAP_LOAD_NUMER / MAP_LOAD_DENOM);
+}
+
+/**
+ * @brief Place the key and value in spare slot without looking for an equal key
+ * @return Slot index where the carried key ended up
+ */
+uint16_t _kaelMap_place(KaelMap *map){
+	uint8_t *carry = _kaelMap_slot(map, map->capacity);
+	uint8_t *swap = _kaelMap_slot(map, map->capacity + 1U);
+	const uint16_t mask = map->capacity - 1U;
+
+	uint16_t index = _kaelMap_home(map, carry);
+	uint16_t probe = 1;
+	uint16_t placed = KAEL_MAP_NONE;
+	while(map->probe[index]!=0){
+		if(map->probe[index] < probe){
+			//Resident is closer to its home, take its slot and carry it onwards
+			uint8_t *resident = _kaelMap_slot(map, index);
+			memcpy(swap, resident, map->stride);
+			memcpy(resident, carry, map->stride);
+			memcpy(carry, swap, map->stride);
+
+			uint16_t residentProbe = map->probe[index];
+			map->probe[index] = probe;
+			probe = residentProbe;
+			placed = placed==KAEL_MAP_NONE ? index : placed;
+		}
+		index = (index + 1U) & mask;
+		probe++;
+	}
+	memcpy(_kaelMap_slot(map, index), carry, map->stride);
+	map->probe[index] = probe;
+	map->length++;
+	return placed==KAEL_MAP_NONE ? index : placed;
+}
+
+/**
+ * @brief Allocate slot and probe tables for capacity slots plus two spare slots
+ * @return Kael_infoCode
+ */
+uint8_t _kaelMap_allocTable(KaelMap *map, const uint16_t capacity){
+	map->slot = KAEL_MALLOC(KAEL_MEM_TREE, ((size_t)capacity + 2U) * map->stride);
+	map->probe = KAEL_CALLOC(KAEL_MEM_TREE, capacity, sizeof(uint16_t));
+	if(map->slot==NULL || map->probe==NULL){
+		KAEL_ERROR_NOTE("KaelMap table alloc failed");
+		KAEL_FREE(map->slot);
+		KAEL_FREE(map->probe);
+		map->slot = NULL;
+		map->probe = NULL;
+		return KAEL_ERR_ALLOC;
+	}
+	map->capacity = capacity;
+	map->length = 0;
+	return KAEL_SUCCESS;
+}
+
+/**
+ * @brief Double the slot count and place every key again
+ * @return Kael_infoCode
+ */
+uint8_t _kaelMap_grow(KaelMap *map){
+	if(map->capacity >= KAEL_MAP_SLOTS_MAX){
+		KAEL_ERROR_NOTE("KaelMap full");
+		return KAEL_ERR_FULL;
+	}
+
+	KaelMap old = *map;
+	uint8_t code = _kaelMap_allocTable(map, old.capacity * 2U);
+	if(code!=KAEL_SUCCESS){
+		*map = old;
+		return code;
+	}
+
+	for(uint16_t i=0; i<old.capacity; i++){
+		if(old.probe[i]==0){continue;}
+		memcpy(_kaelMap_slot(map, map->capacity), _kaelMap_slot(&old, i), map->stride);
+		_kaelMap_place(map);
+	}
+	KAEL_FREE(old.slot);
+	KAEL_FREE(old.probe);
+	return KAEL_SUCCESS;
+}
+
+
+
+
+//------ Alloc / Free ------
+
+/**
+ * @brief Initialize map with room for length keys before first growth
+ * @return Kael_infoCode
+ */
+uint8_t kaelMap_alloc(KaelMap *map, const uint16_t keyWidth, const uint16_t valueWidth, const uint16_t length){
+	if(NULL_CHECK(map)){return KAEL_ERR_NULL;}
+	*map = (KaelMap){0};
+	if(keyWidth==0 || (uint32_t)keyWidth + valueWidth > UINT16_MAX){
+		KAEL_ERROR_NOTE("Invalid KaelMap key or value width");
+		return KAEL_ERR_UNSUPPORTED;
+	}
+	if(length > _kaelMap_fitLength(KAEL_MAP_SLOTS_MAX)){
+		return KAEL_ERR_FULL;
+	}
+
+	uint16_t capacity = MAP_SLOTS_MIN;
+	while(_kaelMap_fitLength(capacity) < length){
+		capacity *= 2U;
+	}
+
+	map->keyWidth = keyWidth;
+	map->valueWidth = valueWidth;
+	map->stride = keyWidth + valueWidth;
+	return _kaelMap_allocTable(map, capacity);
+}
+
+void kaelMap_free(KaelMap *map){
+	if(NULL_CHECK(map)){return;}
+	KAEL_FREE(map->slot);
+	KAEL_FREE(map->probe);
+	*map = (KaelMap){0};
+}
+
+//Remove every key, keeps capacity
+void kaelMap_clear(KaelMap *map){
+	if(NULL_CHECK(map)){return;}
+	memset(map->probe, 0, (size_t)map->capacity * sizeof(uint16_t));
+	map->length = 0;
+}
+
+
+
+
+//------ Manipulate keys ------
+
+/**
+ * @brief Insert key or overwrite its value. NULL value zero fills a new value and keeps an existing one
+ * @return Value address, valid until next set or remove. NULL on failure
+ */
+void *kaelMap_set(KaelMap *map, const void *key, const void *value){
+	if(NULL_CHECK(map) || NULL_CHECK(key)){return NULL;}
+
+	uint16_t index = kaelMap_find(map, key);
+	if(index==KAEL_MAP_NONE){
+		if(map->length >= _kaelMap_fitLength(map->capacity)){
+			if(_kaelMap_grow(map)!=KAEL_SUCCESS){return NULL;}
+		}
+		uint8_t *carry = _kaelMap_slot(map, map->capacity);
+		memcpy(carry, key, map->keyWidth);
+		memset(carry + map->keyWidth, 0, map->valueWidth);
+		index = _kaelMap_place(map);
+	}
+
+	uint8_t *slotValue = _kaelMap_slot(map, index) + map->keyWidth;
+	if(value!=NULL){
+		memcpy(slotValue, value, map->valueWidth);
+	}
+	return slotValue;
+}
+
+/**
+ * @brief Remove key, following keys shift back towards their home slot
+ * @return KAEL_SUCCESS or KAEL_ERR_NULL if key wasn't in the map
+ */
+uint8_t kaelMap_remove(KaelMap *map, const void *key){
+	if(NULL_CHECK(map) || NULL_CHECK(key)){return KAEL_ERR_NULL;}
+	uint16_t index = kaelMap_find(map, key);
+	if(index==KAEL_MAP_NONE){return KAEL_ERR_NULL;}
+
+	const uint16_t mask = map->capacity - 1U;
+	uint16_t next = (index + 1U) & mask;
+	while(map->probe[next] > 1){
+		memcpy(_kaelMap_slot(map, index), _kaelMap_slot(map, next), map->stride);
+		map->probe[index] = map->probe[next] - 1U;
+		index = next;
+		next = (next + 1U) & mask;
+	}
+	map->probe[index] = 0;
+	map->length--;
+	return KAEL_SUCCESS;
+}
+
+
+
+
+//------ Lookup ------
+
+/**
+ * @brief Find slot index of key
+ * @return Slot index or KAEL_MAP_NONE
+ *
+ * @warning No NULL_CHECK
+ */
+uint16_t kaelMap_find(const KaelMap *map, const void *key){
+	KAEL_ASSERT(map!=NULL && key!=NULL);
+	const uint16_t mask = map->capacity - 1U;
+	uint16_t index = _kaelMap_home(map, key);
+	for(uint16_t probe=1; map->probe[index] >= probe; probe++){
+		if(map->probe[index]==probe && memcmp(_kaelMap_slot(map, index), key, map->keyWidth)==0){
+			return index;
+		}
+		index = (index + 1U) & mask;
+	}
+	return KAEL_MAP_NONE;
+}
+
+/**
+ * @brief Get value of key
+ * @return Value address or NULL if key isn't in the map
+ *
+ * @warning No NULL_CHECK
+ */
+void *kaelMap_get(const KaelMap *map, const void *key){
+	uint16_t index = kaelMap_find(map, key);
+	if(index==KAEL_MAP_NONE){return NULL;}
+	return _kaelMap_slot(map, index) + map->keyWidth;
+}
+
+
+
+
+//------ Slot access ------
+
+uint8_t kaelMap_slotUsed(const KaelMap *map, const uint16_t index){
+	if(NULL_CHECK(map)){return 0;}
+	return index < map->capacity && map->probe[index]!=0;
+}
+
+void *kaelMap_slotKey(const KaelMap *map, const uint16_t index){
+	if(!kaelMap_slotUsed(map, index)){return NULL;}
+	return _kaelMap_slot(map, index);
+}
+
+void *kaelMap_slotValue(const KaelMap *map, const uint16_t index){
+	if(!kaelMap_slotUsed(map, index)){return NULL;}
+	return _kaelMap_slot(map, index) + map->keyWidth;
+}
+
+
+
+
+//------ Getters ------
+
+uint16_t kaelMap_length(const KaelMap *map){
+	if(NULL_CHECK(map)){return 0;}
+	return map->length;
+}
+
+uint16_t kaelMap_capacity(const KaelMap *map){
+	if(NULL_CHECK(map)){return 0;}
+	return map->capacity;
+}
@@ -0,0 +1,51 @@
+/**
+ * @file map.h
+ * @brief Open addressing hash map with fixed width keys and values. c++ std::unordered_map like
+ *
+ * Robin Hood probing keeps every key close to its home slot, so lookup is O(1) and a miss stops early.
+ * Slots are addressed by 16-bit indices, capacity is a power of two up to KAEL_MAP_SLOTS_MAX.
+ * Value addresses move when the map grows or a key is removed
+ */
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+//Slot index that never refers to a slot
+#define KAEL_MAP_NONE UINT16_MAX
+
+//Largest slot count, keys fit up to 7/8 of it
+#define KAEL_MAP_SLOTS_MAX 32768U
+
+typedef struct{
+	uint8_t *slot; //key and value pairs, stride bytes each
+	uint16_t *probe; //distance from home slot +1 per slot, 0 if empty
+	uint16_t keyWidth; //key byte width, keys are compared as bytes
+	uint16_t valueWidth; //value byte width
+	uint16_t stride; //keyWidth + valueWidth
+	uint16_t capacity; //number of slots, power of two
+	uint16_t length; //number of keys
+}KaelMap;
+
+uint8_t kaelMap_alloc(KaelMap *map, const uint16_t keyWidth, const uint16_t valueWidth, const uint16_t length);
+void kaelMap_free(KaelMap *map);
+void kaelMap_clear(KaelMap *map);
+
+//Manipulate keys
+void *kaelMap_set(KaelMap *map, const void *key, const void *value);
+uint8_t kaelMap_remove(KaelMap *map, const void *key);
+
+//Lookup
+void *kaelMap_get(const KaelMap *map, const void *key);
+uint16_t kaelMap_find(const KaelMap *map, const void *key);
+
+//Slot access, for iteration over 0..capacity-1
+uint8_t kaelMap_slotUsed(const KaelMap *map, const uint16_t index);
+void *kaelMap_slotKey(const KaelMap *map, const uint16_t index);
+void *kaelMap_slotValue(const KaelMap *map, const uint16_t index);
+
+//Get value
+uint16_t kaelMap_length(const KaelMap *map);
+uint16_t kaelMap_capacity(const KaelMap *map);
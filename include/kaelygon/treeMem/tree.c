@@ -21,14 +21,29 @@
 #include "kaelygon/global/kaelMacros.h"
 #include "kaelygon/treeMem/tree.h"
 #include "kaelygon/math/math.h"
+#include "kaelygon/mem/mem.h"
 
 //if used memory exceeds capacity, scale it by GROWTH_NUMER/GROWTH_DENOM times
-//if capacity requires is less than GROWTH_DENOM/GROWTH_NUMER, it's scaled by that amount
 #define GROWTH_NUMER 3 
 #define GROWTH_DENOM 2 
 
+//if used memory drops to 1/SHRINK_TRIGGER of capacity, capacity is divided by SHRINK_DIVISOR
+//Gap between growth and shrink thresholds keeps push/pop around one length from reallocating every time
+#define SHRINK_TRIGGER 4
+#define SHRINK_DIVISOR 2
+
 #define ELEMS_MAX (UINT16_MAX-1) // -1 that push ->length+1 can be done without a range change
 
+//---private---
+
+//realloc from heap or from tree arena
+void *_kaelTree_realloc(KaelTree *tree, const uint16_t newAlloc){
+	if(tree->arena!=NULL){
+		return kaelArena_resize(tree->arena, tree->data, tree->capacity, newAlloc);
+	}
+	return KAEL_REALLOC(KAEL_MEM_TREE, tree->data, newAlloc);
+}
+
 //---alloc and free---
 
 /**
@@ -41,10 +56,26 @@ uint8_t kaelTree_alloc(KaelTree *tree, const uint16_t size){
 	tree->data = NULL;
 	tree->capacity	= 0;
 	tree->reserve = 0;
+	tree->arena = NULL;
+	tree->shrink = KAEL_TREE_SHRINK_HYSTERESIS;
 	kaelTree_setWidth(tree, size);
 	return KAEL_SUCCESS;
 }
 
+/**
+ * @brief Initialize tree that allocates from arena instead of heap
+ * 
+ * Growth bumps the arena, in place if the tree made the latest arena allocation.
+ * Memory is released by arena rollback or reset, kaelTree_free only forgets it
+ * @return KAEL_SUCCESS or KAEL_ERR_NULL
+ */
+uint8_t kaelTree_allocArena(KaelTree *tree, const uint16_t size, KaelArena *arena){
+	if(NULL_CHECK(tree) || NULL_CHECK(arena)){return KAEL_ERR_NULL;}
+	uint8_t code = kaelTree_alloc(tree, size);
+	tree->arena = arena;
+	return code;
+}
+
 /**
  * @brief Free including all the elements
  * 
@@ -52,7 +83,9 @@ uint8_t kaelTree_alloc(KaelTree *tree, const uint16_t size){
 */
 void kaelTree_free(KaelTree *tree){
 	if(NULL_CHECK(tree,"free") || NULL_CHECK(tree->data,"free->data")){return;} 
-	free(tree->data); //Free branch or leaf
+	if(tree->arena==NULL){
+		KAEL_FREE(tree->data); //Free branch or leaf
+	}
 	memset(tree,0,sizeof(KaelTree)); //set to NULL and 0
 }
 
@@ -82,7 +115,7 @@ uint8_t kaelTree_resize(KaelTree *tree, const uint16_t length){
 			newAlloc = newAlloc * GROWTH_NUMER/GROWTH_DENOM;
 		}
 
-		void *newData = realloc(tree->data, newAlloc);
+		void *newData = _kaelTree_realloc(tree, newAlloc);
 		if( NULL_CHECK(newData) ){ return KAEL_ERR_ALLOC; }
 
 		//Zero newly resized portion if any
@@ -112,7 +145,7 @@ uint8_t kaelTree_reserve(KaelTree *tree, const uint16_t length){
 	uint16_t newAlloc = newLength * tree->width;
 
 	if( newAlloc > tree->capacity ){ 
-		void *newData = realloc(tree->data, newAlloc);
+		void *newData = _kaelTree_realloc(tree, newAlloc);
 		if( NULL_CHECK(newData) ){ return KAEL_ERR_ALLOC; }
 
 		//Zero newly resized portion if any
@@ -128,6 +161,34 @@ uint8_t kaelTree_reserve(KaelTree *tree, const uint16_t length){
 	return KAEL_SUCCESS;
 }
 
+/**
+ * @brief Choose how pop releases capacity
+ */
+void kaelTree_setShrink(KaelTree *tree, const KaelTree_shrinkPolicy policy){
+	if(NULL_CHECK(tree)){return;}
+	tree->shrink = policy;
+}
+
+/**
+ * @brief Release capacity beyond length or reserve, whichever is larger. At least one element stays allocated
+ * @return Kael_infoCode
+ */
+uint8_t kaelTree_shrinkToFit(KaelTree *tree){
+	if(NULL_CHECK(tree)){return KAEL_ERR_NULL;}
+	if(tree->data==NULL){return KAEL_SUCCESS;}
+
+	uint16_t minAlloc = kaelMath_max(tree->length, tree->reserve);
+	minAlloc = kaelMath_max(minAlloc, 1);
+	uint16_t newAlloc = minAlloc * tree->width;
+	if( newAlloc >= tree->capacity ){return KAEL_SUCCESS;}
+
+	void *newData = _kaelTree_realloc(tree, newAlloc);
+	if( NULL_CHECK(newData) ){ return KAEL_ERR_ALLOC; }
+	tree->capacity=newAlloc;
+	tree->data=newData;
+	return KAEL_SUCCESS;
+}
+
 /**
  * @brief Insert at index. NULL element is initialized as zero
  * @return On success return newly pushed element address. On fail return NULL 
@@ -179,7 +240,79 @@ void *kaelTree_push(KaelTree *tree, const void *restrict element){
 }
 
 /**
- * @brief Remove last element
+ * @brief Add count elements with one resize and one copy. NULL elements are initialized as zero
+ * @return On success return address of the first new element. On fail return NULL 
+ */
+void *kaelTree_pushN(KaelTree *tree, const void *restrict elements, const uint16_t count){
+	if(NULL_CHECK(tree)){return NULL;}
+	if(count==0 || count > ELEMS_MAX - tree->length){return NULL;}
+
+	uint16_t oldLength = tree->length;
+	uint8_t code = kaelTree_resize(tree, oldLength+count);
+	if(code!=KAEL_SUCCESS){return NULL;}
+
+	void *dest = (uint8_t *)tree->data + oldLength * tree->width;
+	if(elements==NULL){
+		memset(dest, 0, count * tree->width);
+	}else{
+		memcpy(dest, elements, count * tree->width);
+	}
+	return dest;
+}
+
+/**
+ * @brief Append count elements of src starting from index. Trees must have the same width and not be the same tree
+ * @return On success return address of the first new element. On fail return NULL 
+ */
+void *kaelTree_appendRange(KaelTree *tree, const KaelTree *src, const uint16_t index, const uint16_t count){
+	if(NULL_CHECK(tree) || NULL_CHECK(src)){return NULL;}
+	KAEL_ASSERT(tree->width==src->width, "kaelTree_appendRange width mismatch");
+	KAEL_ASSERT(index+count <= src->length, "kaelTree_appendRange out of bounds");
+	if(count==0){return NULL;}
+	return kaelTree_pushN(tree, (uint8_t *)src->data + index * src->width, count);
+}
+
+/**
+ * @brief Add one element without copying. Contents are unspecified, write them through the returned pointer
+ * @return On success return address of new element. On fail return NULL 
+ */
+void *kaelTree_emplace(KaelTree *tree){
+	if(NULL_CHECK(tree)){return NULL;}
+	uint8_t code = kaelTree_resize(tree, tree->length+1);
+	if(code!=KAEL_SUCCESS){return NULL;}
+	return (uint8_t *)tree->data + (tree->length-1) * tree->width;
+}
+
+/**
+ * @brief Make room for up to count elements after the last one without changing length
+ * 
+ * Write elements through the returned span, then kaelTree_commitSpan the number written.
+ * Any other tree call in between may move the span
+ * @return On success return address right after the last element. On fail return NULL 
+ */
+void *kaelTree_reserveSpan(KaelTree *tree, const uint16_t count){
+	if(NULL_CHECK(tree)){return NULL;}
+	if(count > ELEMS_MAX - tree->length){return NULL;}
+	uint16_t oldLength = tree->length;
+	uint8_t code = kaelTree_resize(tree, oldLength+count);
+	tree->length = oldLength;
+	if(code!=KAEL_SUCCESS){return NULL;}
+	return (uint8_t *)tree->data + oldLength * tree->width;
+}
+
+/**
+ * @brief Add count elements written through kaelTree_reserveSpan
+ * 
+ * @warning No NULL_CHECK. count must not exceed the reserved span
+ */
+void kaelTree_commitSpan(KaelTree *tree, const uint16_t count){
+	KAEL_ASSERT(tree!=NULL);
+	KAEL_ASSERT((uint32_t)(tree->length+count) * tree->width <= tree->capacity, "kaelTree_commitSpan beyond reserved span");
+	tree->length += count;
+}
+
+/**
+ * @brief Remove last element. Capacity shrinks according to tree shrink policy
  * @return Kael_infoCode
  */
 uint8_t kaelTree_pop(KaelTree *tree){
@@ -187,21 +320,31 @@ uint8_t kaelTree_pop(KaelTree *tree){
 
 	uint16_t newLength = tree->length -1;
 
-	uint16_t minAlloc = kaelMath_max(newLength, tree->reserve);
-	uint16_t newAlloc = tree->width * minAlloc;
-	uint16_t scaleAlloc = (tree->capacity/GROWTH_NUMER)*GROWTH_DENOM;
-	if( newAlloc <= scaleAlloc ){ //shrink if below threshold
-		newAlloc = tree->capacity/GROWTH_NUMER*GROWTH_DENOM;
-		void *newData = realloc(tree->data, newAlloc);
-		if( NULL_CHECK(newData,"popRealloc") ){ return KAEL_ERR_ALLOC; }
-		tree->capacity=newAlloc;
-		tree->data=newData;
+	if(tree->shrink == KAEL_TREE_SHRINK_HYSTERESIS){
+		uint16_t minAlloc = kaelMath_max(newLength, tree->reserve);
+		uint16_t usedAlloc = tree->width * minAlloc;
+		//shrink if below threshold, at least one element stays allocated
+		if( usedAlloc <= tree->capacity/SHRINK_TRIGGER && tree->capacity/SHRINK_DIVISOR >= tree->width ){
+			uint16_t newAlloc = tree->capacity/SHRINK_DIVISOR;
+			void *newData = _kaelTree_realloc(tree, newAlloc);
+			if( NULL_CHECK(newData,"popRealloc") ){ return KAEL_ERR_ALLOC; }
+			tree->capacity=newAlloc;
+			tree->data=newData;
+		}
 	}
 
 	tree->length=newLength;
 	return KAEL_SUCCESS;
 }
 
+/**
+ * @brief Remove all elements. Capacity is kept
+ */
+void kaelTree_clear(KaelTree *tree){
+	if(NULL_CHECK(tree)){return;}
+	tree->length = 0;
+}
+
 //---setters---
 
 /**
@@ -262,26 +405,25 @@ void *kaelTree_back(const KaelTree *tree){
 	return elem;
 }
 
+//get address one past the last element, equals begin if empty. No bounds assert so it's safe on empty trees
+void *kaelTree_end(const KaelTree *tree){
+	KAEL_ASSERT(tree != NULL);
+	return (uint8_t *)tree->data + tree->length * tree->width;
+}
+
 //Set **current to next element 
 void kaelTree_next(const KaelTree *tree, void **current){
 	KAEL_ASSERT(current != NULL && tree != NULL);
-	void *next = (uint8_t *)(*current) + tree->width;
-	void *back = kaelTree_back(tree);
-	if((void *)next > (void *)back){
-		*current=NULL;
-		return;
-	}
-	*current=next;
+	uint8_t *next = (uint8_t *)(*current) + tree->width;
+	*current = next < (uint8_t *)kaelTree_end(tree) ? next : NULL;
 }
 
 //Set **current to previous element 
 void kaelTree_prev(const KaelTree *tree, void **current){
 	KAEL_ASSERT(current != NULL && tree != NULL);
-	void *prev = (uint8_t *)(*current) - tree->width;
-	void *front = kaelTree_begin(tree);
-	if((void *)prev < (void *)front){
+	if((uint8_t *)(*current) <= (uint8_t *)tree->data){
 		*current=NULL;
 		return;
 	}
-	*current=prev;
+	*current = (uint8_t *)(*current) - tree->width;
 }
@@ -2,6 +2,7 @@
  * @file tree.h
  * @brief 16-bit uint c++ std::vector like data
  * Can hold any same width type in a single tree 
+ * See typedTree.h for compile-time width variants
  */
 #pragma once
 
@@ -10,6 +11,12 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "kaelygon/mem/arena.h"
+
+typedef enum{
+	KAEL_TREE_SHRINK_HYSTERESIS = 0, //pop halves capacity once only a quarter is used
+	KAEL_TREE_SHRINK_NEVER, //pop keeps capacity at its high-water mark, only kaelTree_shrinkToFit releases it
+}KaelTree_shrinkPolicy;
 
 typedef struct{
 	void *data;
@@ -18,19 +25,30 @@ typedef struct{
 	uint16_t capacity; //available memory
 	uint16_t maxLength; //maximum allowed number of elements before address overflow
 	uint16_t reserve; //reserved number of elements specified by user
+	KaelArena *arena; //NULL for heap
+	uint8_t shrink; //KaelTree_shrinkPolicy
 }KaelTree;
 
 uint8_t kaelTree_alloc(KaelTree *tree, const uint16_t width);
+uint8_t kaelTree_allocArena(KaelTree *tree, const uint16_t width, KaelArena *arena);
 void kaelTree_free(KaelTree *tree);
 
 //Config tree
 void kaelTree_setWidth(KaelTree *tree, const uint16_t width);
 uint8_t kaelTree_resize(KaelTree *tree, const uint16_t n);
 uint8_t kaelTree_reserve(KaelTree *tree, const uint16_t length);
+void kaelTree_setShrink(KaelTree *tree, const KaelTree_shrinkPolicy policy);
+uint8_t kaelTree_shrinkToFit(KaelTree *tree);
 
 //Manipulate elements
 void *kaelTree_push(KaelTree *tree, const void *restrict element);
+void *kaelTree_pushN(KaelTree *tree, const void *restrict elements, const uint16_t count);
+void *kaelTree_appendRange(KaelTree *tree, const KaelTree *src, const uint16_t index, const uint16_t count);
+void *kaelTree_emplace(KaelTree *tree);
+void *kaelTree_reserveSpan(KaelTree *tree, const uint16_t count);
+void kaelTree_commitSpan(KaelTree *tree, const uint16_t count);
 uint8_t kaelTree_pop(KaelTree *tree);
+void kaelTree_clear(KaelTree *tree);
 void *kaelTree_insert(KaelTree *tree, uint16_t index, const void *restrict element);
 void kaelTree_set(KaelTree *tree, const uint16_t index, const void *restrict element);
 
@@ -39,6 +57,7 @@ void *kaelTree_get(const KaelTree *tree, uint16_t index);
 
 void *kaelTree_begin(const KaelTree *tree);
 void *kaelTree_back(const KaelTree *tree);
+void *kaelTree_end(const KaelTree *tree);
 
 //Get value
 uint16_t kaelTree_length(const KaelTree *tree);
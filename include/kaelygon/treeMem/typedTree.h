@@ -0,0 +1,295 @@
+/**
+ * @file typedTree.h
+ *
+ * @brief Header only, compile-time specialized KaelTree. c++ std::vector<T> like
+ *
+ * KAEL_TREE_DEFINE(Name, T) generates struct KaelTree_Name holding T elements and
+ * static inline kaelTree_Name_* functions. Element width is sizeof(T), so indexing compiles to
+ * plain pointer arithmetic instead of runtime width multiplies through void*.
+ * Same 16-bit limit and growth factor as KaelTree, capacity never exceeds UINT16_MAX-1 bytes.
+ * KAEL_TREE_DEFINE_SMALL(Name, T, N) has the same functions but keeps up to N elements inline
+ *
+ * @code
+ * KAEL_TREE_DEFINE(u16, uint16_t)
+ *
+ * KaelTree_u16 tree;
+ * kaelTree_u16_alloc(&tree);
+ * kaelTree_u16_push(&tree, 42);
+ * KAEL_TREE_FOREACH(it, &tree){
+ * 	*it += 1;
+ * }
+ * kaelTree_u16_free(&tree);
+ * @endcode
+ */
+#pragma once
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "kaelygon/global/kaelMacros.h"
+#include "kaelygon/mem/mem.h"
+
+//Same growth factor and byte limit as tree.c
+#define KAEL_TYPED_TREE_GROWTH_NUMER 3U
+#define KAEL_TYPED_TREE_GROWTH_DENOM 2U
+#define KAEL_TYPED_TREE_BYTES_MAX (UINT16_MAX-1U)
+
+/**
+ * @brief Iterate every element of a typed tree by pointer. End is read once before the loop
+ *
+ * @warning Loop body must not push, pop or otherwise reallocate the tree
+ */
+#define KAEL_TREE_FOREACH(it, tree) \
+	for(typeof((tree)->data + 0) it = (tree)->data, it##_end = (tree)->data + (tree)->length; it < it##_end; it++)
+
+#define KAEL_TREE_DEFINE(Name, T) \
+\
+typedef struct{ \
+	T *data; \
+	uint16_t length; /* number of elements */ \
+	uint16_t capacity; /* allocated elements */ \
+}KaelTree_##Name; \
+\
+_KAEL_TREE_MAX_LENGTH(Name, T) \
+_KAEL_TREE_HEAP_STORAGE(Name, T) \
+_KAEL_TREE_ELEMENTS(Name, T)
+
+/**
+ * @brief Same as KAEL_TREE_DEFINE, but the first N elements are stored inline in the struct
+ *
+ * Heap is used only when the tree grows past N elements, shrinkToFit moves it back inline when it fits.
+ * Tiny trees then cost no allocation and no pointer chase to a separate heap block
+ *
+ * @warning data points into the struct itself, don't copy or move an allocated tree by value
+ */
+#define KAEL_TREE_DEFINE_SMALL(Name, T, N) \
+\
+_Static_assert((N) > 0 && (N) * sizeof(T) <= KAEL_TYPED_TREE_BYTES_MAX, "KaelTree_" #Name " inline storage out of range"); \
+\
+typedef struct{ \
+	T *data; /* local or heap */ \
+	uint16_t length; /* number of elements */ \
+	uint16_t capacity; /* allocated elements, N while inline */ \
+	T local[N]; /* inline storage */ \
+}KaelTree_##Name; \
+\
+_KAEL_TREE_MAX_LENGTH(Name, T) \
+_KAEL_TREE_SMALL_STORAGE(Name, T, N) \
+_KAEL_TREE_ELEMENTS(Name, T)
+
+
+
+
+//------ Storage ------
+
+//Largest element count that keeps byte size in 16 bits
+#define _KAEL_TREE_MAX_LENGTH(Name, T) \
+static inline uint16_t kaelTree_##Name##_maxLength(void){ \
+	return KAEL_TYPED_TREE_BYTES_MAX / sizeof(T); \
+}
+
+//alloc, free, reserve and shrinkToFit of a tree that is always on heap
+#define _KAEL_TREE_HEAP_STORAGE(Name, T) \
+\
+static inline uint8_t kaelTree_##Name##_alloc(KaelTree_##Name *tree){ \
+	if(NULL_CHECK(tree)){return KAEL_ERR_NULL;} \
+	*tree = (KaelTree_##Name){0}; \
+	return KAEL_SUCCESS; \
+} \
+\
+static inline void kaelTree_##Name##_free(KaelTree_##Name *tree){ \
+	if(NULL_CHECK(tree)){return;} \
+	KAEL_FREE(tree->data); \
+	*tree = (KaelTree_##Name){0}; \
+} \
+\
+/* Allocate at least count elements. Never shrinks */ \
+static inline uint8_t kaelTree_##Name##_reserve(KaelTree_##Name *tree, uint16_t count){ \
+	if(NULL_CHECK(tree)){return KAEL_ERR_NULL;} \
+	if(count <= tree->capacity){return KAEL_SUCCESS;} \
+	if(count > kaelTree_##Name##_maxLength()){return KAEL_ERR_FULL;} \
+	T *newData = KAEL_REALLOC(KAEL_MEM_TREE, tree->data, (size_t)count * sizeof(T)); \
+	if(NULL_CHECK(newData)){return KAEL_ERR_ALLOC;} \
+	tree->data = newData; \
+	tree->capacity = count; \
+	return KAEL_SUCCESS; \
+} \
+\
+/* Release capacity beyond length, empty tree frees its data */ \
+static inline uint8_t kaelTree_##Name##_shrinkToFit(KaelTree_##Name *tree){ \
+	if(NULL_CHECK(tree)){return KAEL_ERR_NULL;} \
+	if(tree->length == tree->capacity){return KAEL_SUCCESS;} \
+	if(tree->length == 0){ \
+		KAEL_FREE(tree->data); \
+		tree->data = NULL; \
+		tree->capacity = 0; \
+		return KAEL_SUCCESS; \
+	} \
+	T *newData = KAEL_REALLOC(KAEL_MEM_TREE, tree->data, (size_t)tree->length * sizeof(T)); \
+	if(NULL_CHECK(newData)){return KAEL_ERR_ALLOC;} \
+	tree->data = newData; \
+	tree->capacity = tree->length; \
+	return KAEL_SUCCESS; \
+}
+
+//alloc, free, reserve and shrinkToFit of a tree that starts in its local array
+#define _KAEL_TREE_SMALL_STORAGE(Name, T, N) \
+\
+static inline uint8_t kaelTree_##Name##_alloc(KaelTree_##Name *tree){ \
+	if(NULL_CHECK(tree)){return KAEL_ERR_NULL;} \
+	tree->data = tree->local; \
+	tree->length = 0; \
+	tree->capacity = (N); \
+	return KAEL_SUCCESS; \
+} \
+\
+static inline void kaelTree_##Name##_free(KaelTree_##Name *tree){ \
+	if(NULL_CHECK(tree)){return;} \
+	if(tree->data != tree->local){ \
+		KAEL_FREE(tree->data); \
+	} \
+	tree->data = NULL; \
+	tree->length = 0; \
+	tree->capacity = 0; \
+} \
+\
+/* Allocate at least count elements. Never shrinks, first growth past N moves elements to heap */ \
+static inline uint8_t kaelTree_##Name##_reserve(KaelTree_##Name *tree, uint16_t count){ \
+	if(NULL_CHECK(tree)){return KAEL_ERR_NULL;} \
+	if(count <= tree->capacity){return KAEL_SUCCESS;} \
+	if(count > kaelTree_##Name##_maxLength()){return KAEL_ERR_FULL;} \
+	T *newData; \
+	if(tree->data == tree->local){ \
+		newData = KAEL_MALLOC(KAEL_MEM_TREE, (size_t)count * sizeof(T)); \
+		if(NULL_CHECK(newData)){return KAEL_ERR_ALLOC;} \
+		memcpy(newData, tree->local, (size_t)tree->length * sizeof(T)); \
+	}else{ \
+		newData = KAEL_REALLOC(KAEL_MEM_TREE, tree->data, (size_t)count * sizeof(T)); \
+		if(NULL_CHECK(newData)){return KAEL_ERR_ALLOC;} \
+	} \
+	tree->data = newData; \
+	tree->capacity = count; \
+	return KAEL_SUCCESS; \
+} \
+\
+/* Release capacity beyond length, move back inline if elements fit */ \
+static inline uint8_t kaelTree_##Name##_shrinkToFit(KaelTree_##Name *tree){ \
+	if(NULL_CHECK(tree)){return KAEL_ERR_NULL;} \
+	if(tree->data == tree->local || tree->length == tree->capacity){return KAEL_SUCCESS;} \
+	if(tree->length <= (N)){ \
+		memcpy(tree->local, tree->data, (size_t)tree->length * sizeof(T)); \
+		KAEL_FREE(tree->data); \
+		tree->data = tree->local; \
+		tree->capacity = (N); \
+		return KAEL_SUCCESS; \
+	} \
+	T *newData = KAEL_REALLOC(KAEL_MEM_TREE, tree->data, (size_t)tree->length * sizeof(T)); \
+	if(NULL_CHECK(newData)){return KAEL_ERR_ALLOC;} \
+	tree->data = newData; \
+	tree->capacity = tree->length; \
+	return KAEL_SUCCESS; \
+}
+
+
+
+
+//------ Elements ------
+
+//Element access shared by both storage variants, they only differ in reserve
+#define _KAEL_TREE_ELEMENTS(Name, T) \
+\
+/* Grow capacity by growth factor so it fits count elements */ \
+static inline uint8_t _kaelTree_##Name##_grow(KaelTree_##Name *tree, uint16_t count){ \
+	uint32_t newCapacity = (uint32_t)count * KAEL_TYPED_TREE_GROWTH_NUMER / KAEL_TYPED_TREE_GROWTH_DENOM + 1U; \
+	uint16_t maxLength = kaelTree_##Name##_maxLength(); \
+	if(count > maxLength){return KAEL_ERR_FULL;} \
+	return kaelTree_##Name##_reserve(tree, newCapacity > maxLength ? maxLength : (uint16_t)newCapacity); \
+} \
+\
+/* Add element by value. Return its address or NULL if full */ \
+static inline T *kaelTree_##Name##_push(KaelTree_##Name *tree, T element){ \
+	KAEL_ASSERT(tree!=NULL); \
+	if(tree->length==tree->capacity && _kaelTree_##Name##_grow(tree, tree->length+1U)!=KAEL_SUCCESS){ \
+		return NULL; \
+	} \
+	T *dest = tree->data + tree->length++; \
+	*dest = element; \
+	return dest; \
+} \
+\
+/* Add count elements with one copy. NULL elements are zeroed. Return first new element or NULL */ \
+static inline T *kaelTree_##Name##_pushN(KaelTree_##Name *tree, const T *elements, uint16_t count){ \
+	KAEL_ASSERT(tree!=NULL); \
+	if(count==0 || count > kaelTree_##Name##_maxLength() - tree->length){return NULL;} \
+	uint16_t newLength = tree->length + count; \
+	if(newLength > tree->capacity && _kaelTree_##Name##_grow(tree, newLength)!=KAEL_SUCCESS){ \
+		return NULL; \
+	} \
+	T *dest = tree->data + tree->length; \
+	if(elements==NULL){ \
+		memset(dest, 0, (size_t)count * sizeof(T)); \
+	}else{ \
+		memcpy(dest, elements, (size_t)count * sizeof(T)); \
+	} \
+	tree->length = newLength; \
+	return dest; \
+} \
+\
+/* Add one element to be written through the returned pointer. Return NULL if full */ \
+static inline T *kaelTree_##Name##_emplace(KaelTree_##Name *tree){ \
+	KAEL_ASSERT(tree!=NULL); \
+	if(tree->length==tree->capacity && _kaelTree_##Name##_grow(tree, tree->length+1U)!=KAEL_SUCCESS){ \
+		return NULL; \
+	} \
+	return tree->data + tree->length++; \
+} \
+\
+/* Remove last element. Capacity is kept */ \
+static inline uint8_t kaelTree_##Name##_pop(KaelTree_##Name *tree){ \
+	KAEL_ASSERT(tree!=NULL); \
+	if(tree->length==0){return KAEL_ERR_NULL;} \
+	tree->length--; \
+	return KAEL_SUCCESS; \
+} \
+\
+/* Remove all elements. Capacity is kept */ \
+static inline void kaelTree_##Name##_clear(KaelTree_##Name *tree){ \
+	KAEL_ASSERT(tree!=NULL); \
+	tree->length = 0; \
+} \
+\
+static inline T *kaelTree_##Name##_get(const KaelTree_##Name *tree, uint16_t index){ \
+	KAEL_ASSERT(tree!=NULL); \
+	KAEL_ASSERT(index < tree->length, "kaelTree_" #Name "_get out of bounds"); \
+	return tree->data + index; \
+} \
+\
+/* First element, equals end if empty */ \
+static inline T *kaelTree_##Name##_begin(const KaelTree_##Name *tree){ \
+	KAEL_ASSERT(tree!=NULL); \
+	return tree->data; \
+} \
+\
+/* Last element */ \
+static inline T *kaelTree_##Name##_back(const KaelTree_##Name *tree){ \
+	KAEL_ASSERT(tree!=NULL); \
+	KAEL_ASSERT(tree->length > 0, "kaelTree_" #Name "_back of empty tree"); \
+	return tree->data + tree->length - 1; \
+} \
+\
+/* One past the last element */ \
+static inline T *kaelTree_##Name##_end(const KaelTree_##Name *tree){ \
+	KAEL_ASSERT(tree!=NULL); \
+	return tree->data + tree->length; \
+} \
+\
+static inline uint16_t kaelTree_##Name##_length(const KaelTree_##Name *tree){ \
+	KAEL_ASSERT(tree!=NULL); \
+	return tree->length; \
+} \
+\
+static inline uint8_t kaelTree_##Name##_empty(const KaelTree_##Name *tree){ \
+	KAEL_ASSERT(tree!=NULL); \
+	return tree->length==0; \
+}
@@ -36,22 +36,21 @@ void krle_TGAToKRLE(const char *TGAFile, const char *KRLEFile, uint8_t stretchFa
 	
 
 	//Convert TGA to KRLE string
-	KaelTree krleTree = {0};
-	kaelTree_alloc(&krleTree,sizeof(uint8_t));
+	KaelBankTree krleTree = {0};
+	kaelBankTree_alloc(&krleTree,sizeof(uint8_t));
 	krle_pixelsToKRLE(&krleTree, orchisPaletteLAB, TGAPixels, TGAHeader.width, TGAHeader.height, stretchFactor, sampleType);
-	free(TGAPixels);
+	KAEL_FREE(TGAPixels);
 
 	uint16_t squashedHeight = (TGAHeader.height+(stretchFactor-1))/stretchFactor; //ceil
-	Krle_header KRLEHeader = krle_createKRLEHeader( TGAHeader.width, squashedHeight, kaelTree_length(&krleTree), stretchFactor);
+	Krle_header KRLEHeader = krle_createKRLEHeader( TGAHeader.width, squashedHeight, kaelBankTree_length(&krleTree), stretchFactor);
 
-	const uint8_t *KRLEString = kaelTree_get(&krleTree, 0);
-	krle_writeKRLEFile(KRLEString, KRLEHeader, KRLEFile);
-	kaelTree_free(&krleTree);
+	krle_writeKRLEBanks(&krleTree, KRLEHeader, KRLEFile);
+	kaelBankTree_free(&krleTree);
 
 
 	//Info printing
 	#if KRLE_PRINT_INFO==1
-		uint16_t compressedSize = KRLEHeader.length;
+		uint32_t compressedSize = KRLEHeader.length;
 		uint32_t stretchedPixels = TGAHeader.width*TGAHeader.height/stretchFactor;
 		float bytesPerPixel =  8.0*(float)compressedSize/(stretchedPixels);
 		float pixelsPerByte = (float)stretchedPixels/compressedSize;
@@ -79,8 +78,8 @@ void krle_KRLEToTGA(const char *KRLEFile, const char *TGAFile){
 	Krle_TGAHeader TGAHeader = krle_createTGAHeader(KRLEHeader.width, KRLEHeader.height*KRLEHeader.ratio);
 	krle_writeTGAFile(TGAFile, TGAHeader, TGAPixels);
 
-	free(TGAPixels);
-	free(KRLEString);
+	KAEL_FREE(TGAPixels);
+	KAEL_FREE(KRLEString);
 }
 
 
@@ -89,7 +88,7 @@ void krle_KRLEToTGA(const char *KRLEFile, const char *TGAFile){
 /**
  * @brief Read and copy TGA file BGRA32 pixels to a new allocation
  * 
- * @note TGAPixels must be freed after use
+ * @note TGAPixels must be freed with KAEL_FREE after use
  */
 Krle_TGAHeader krle_readTGAFile(const char *filePath, uint8_t **TGAPixels){
 	FILE *file = fopen(filePath, "rb");
@@ -107,7 +106,7 @@ Krle_TGAHeader krle_readTGAFile(const char *filePath, uint8_t **TGAPixels){
 		return (Krle_TGAHeader){0};
 	}
 	
-	*TGAPixels = calloc(4 * header.width * header.height, sizeof(uint8_t)); // 4 bytes per pixel BGRA
+	*TGAPixels = KAEL_CALLOC(KAEL_MEM_KRLE, 4 * header.width * header.height, sizeof(uint8_t)); // 4 bytes per pixel BGRA
 	if(NULL_CHECK(*TGAPixels)){
 		return (Krle_TGAHeader){0};
 	}
@@ -152,7 +151,7 @@ Krle_TGAHeader krle_createTGAHeader(uint16_t width, uint16_t height){
 /**
  * @brief Read and copy KRLE file into string
  * 
- * @note KRLEString must freed after use
+ * @note KRLEString must be freed with KAEL_FREE after use
  */
 Krle_header krle_readKRLEFile(const char *filePath, uint8_t **KRLEString){
 	FILE *file = fopen(filePath, "rb");
@@ -170,7 +169,7 @@ Krle_header krle_readKRLEFile(const char *filePath, uint8_t **KRLEString){
 		return (Krle_header){0};
 	}
 	
-	*KRLEString = calloc(header.length*sizeof(uint8_t), 1);
+	*KRLEString = KAEL_CALLOC(KAEL_MEM_KRLE, header.length*sizeof(uint8_t), 1);
 	if(NULL_CHECK(*KRLEString)){
 		return (Krle_header){0};
 	}
@@ -196,6 +195,29 @@ void krle_writeKRLEFile(const uint8_t *KRLEString, Krle_header KRLEHeader, const
 	fclose(outFile);
 }
 
+/**
+ * @brief Write krle string stored in banks to file one bank at a time
+ */
+void krle_writeKRLEBanks(const KaelBankTree *krleTree, Krle_header KRLEHeader, const char* fileName){
+	if(NULL_CHECK(krleTree)){
+		return;
+	}
+
+	FILE *outFile = fopen(fileName, "wb");
+	if(!outFile){
+		printf("Failed to open %s\n", fileName);
+		return;
+	}
+	fwrite(&KRLEHeader, sizeof(Krle_header), 1, outFile);
+
+	uint32_t bankLength = 0;
+	const uint8_t *bank = NULL;
+	for(uint16_t i=0; (bank = kaelBankTree_getBank(krleTree, i, &bankLength)); i++){
+		fwrite(bank, bankLength*sizeof(uint8_t), 1, outFile);
+	}
+	fclose(outFile);
+}
+
 /**
  * @brief Create default krle header template
  */
@@ -226,30 +248,45 @@ Krle_header krle_createKRLEHeader(uint16_t width, uint16_t height, uint32_t leng
 
 /**
  * @brief Append jump run to krle string
+ * 
+ * Runs are written through a reserved span, one resize per KRLE_SPAN_RUNS runs instead of one per byte
  */
-uint8_t krle_packJumpRun(KaelTree *krleTree, uint32_t *jumpLength, uint32_t maxJump){
+uint8_t krle_packJumpRun(KaelBankTree *krleTree, uint32_t *jumpLength, uint32_t maxJump){
 	#if KRLE_EXTRA_DEBUGGING==1
 		printf("Jump runs ");
 	#endif
-	void *lastElement = NULL;
 
 	while(*jumpLength){
-		uint8_t runLength = kaelMath_min(*jumpLength, maxJump);
-
-		lastElement = kaelTree_push(krleTree,&(uint8_t){KRLE_PIXEL_JUMP});
-		if(lastElement == NULL){
+		uint32_t runCount = (*jumpLength + maxJump-1) / maxJump;
+		runCount = runCount < KRLE_SPAN_RUNS ? runCount : KRLE_SPAN_RUNS;
+		uint32_t spanLength = 0;
+		uint8_t *span = kaelBankTree_reserveSpan(krleTree, runCount*2, &spanLength);
+		if(span == NULL){
 			return KAEL_ERR_NULL;
 		}
 
-		lastElement = kaelTree_push(krleTree,&(uint8_t){runLength});
-		if(lastElement == NULL){
-			return KAEL_ERR_NULL;
+		if(spanLength < 2){
+			//One byte left in bank, pushN splits the pair across banks
+			uint8_t runLength = kaelMath_min(*jumpLength, maxJump);
+			if(kaelBankTree_pushN(krleTree, (uint8_t[]){KRLE_PIXEL_JUMP, runLength}, 2) == NULL){
+				return KAEL_ERR_NULL;
+			}
+			*jumpLength -= runLength;
+			continue;
 		}
-		
-		#if KRLE_EXTRA_DEBUGGING==1
-			printf("%d ",runLength);
-		#endif
-		*jumpLength -= runLength;
+
+		uint32_t written = 0;
+		while(*jumpLength && written+1 < spanLength){
+			uint8_t runLength = kaelMath_min(*jumpLength, maxJump);
+			span[written++] = KRLE_PIXEL_JUMP;
+			span[written++] = runLength;
+
+			#if KRLE_EXTRA_DEBUGGING==1
+				printf("%d ",runLength);
+			#endif
+			*jumpLength -= runLength;
+		}
+		kaelBankTree_commitSpan(krleTree, written);
 	}
 	
 	#if KRLE_EXTRA_DEBUGGING==1
@@ -261,25 +298,33 @@ uint8_t krle_packJumpRun(KaelTree *krleTree, uint32_t *jumpLength, uint32_t maxJ
 /**
  * @brief Append pixel run to krle string
  */
-uint8_t krle_packPixelRun(KaelTree *krleTree, uint8_t paletteIndex, uint32_t *pixelLength, uint32_t maxPixelLength){
+uint8_t krle_packPixelRun(KaelBankTree *krleTree, uint8_t paletteIndex, uint32_t *pixelLength, uint32_t maxPixelLength){
 	//Chain of same pixels ended
 	#if KRLE_EXTRA_DEBUGGING==1
 		printf("palette %u runs ", paletteIndex);
 	#endif
 
 	while(*pixelLength){
-		uint8_t runLength = kaelMath_min(*pixelLength, maxPixelLength);
-		uint8_t pixelByte = kaelMath_u8pack(paletteIndex, runLength);
-		void *lastElement = kaelTree_push(krleTree,&(uint8_t){pixelByte});
-		if(lastElement == NULL){
+		uint32_t runCount = (*pixelLength + maxPixelLength-1) / maxPixelLength;
+		runCount = runCount < KRLE_SPAN_RUNS ? runCount : KRLE_SPAN_RUNS;
+		uint32_t spanLength = 0;
+		uint8_t *span = kaelBankTree_reserveSpan(krleTree, runCount, &spanLength);
+		if(span == NULL){
 			*pixelLength=0;
 			return KAEL_ERR_NULL;
 		}
 
-		#if KRLE_EXTRA_DEBUGGING==1
-			printf("%d ",runLength);
-		#endif
-		*pixelLength -= runLength;
+		uint32_t written = 0;
+		while(*pixelLength && written < spanLength){
+			uint8_t runLength = kaelMath_min(*pixelLength, maxPixelLength);
+			span[written++] = kaelMath_u8pack(paletteIndex, runLength);
+
+			#if KRLE_EXTRA_DEBUGGING==1
+				printf("%d ",runLength);
+			#endif
+			*pixelLength -= runLength;
+		}
+		kaelBankTree_commitSpan(krleTree, written);
 	}
 	
 	#if KRLE_EXTRA_DEBUGGING==1
@@ -331,10 +376,11 @@ uint8_t krle_increment(Krle_iterator *it){
 }
 
 /**
- * @brief encode TGA (BGRA32) pixels into krle string stored as KaelTree
+ * @brief encode TGA (BGRA32) pixels into krle string stored as KaelBankTree
  * 
+ * String may exceed 64 KiB, write it with krle_writeKRLEBanks or flatten with kaelBankTree_copyOut
  */
-void krle_pixelsToKRLE(KaelTree *krleTree, const Krle_LAB *labPalette, const uint8_t *TGAPixels, uint16_t TGAWidth, uint16_t TGAHeight, uint8_t stretchFactor, uint8_t sampleType){
+void krle_pixelsToKRLE(KaelBankTree *krleTree, const Krle_LAB *labPalette, const uint8_t *TGAPixels, uint16_t TGAWidth, uint16_t TGAHeight, uint8_t stretchFactor, uint8_t sampleType){
 	if(NULL_CHECK(krleTree) || NULL_CHECK(labPalette) || NULL_CHECK(TGAPixels) ){
 		return;
 	}
@@ -342,8 +388,8 @@ void krle_pixelsToKRLE(KaelTree *krleTree, const Krle_LAB *labPalette, const uin
 
 	//Raw 5 bit colors per pixel (4bit colors 1bit alpha), 1.6 pixels in byte
 	//Converted fromat fits 3-2 pixels into one byte. Worst case scenario ~8 bits in one byte  
-	kaelTree_setWidth(krleTree,sizeof(uint8_t));
-	kaelTree_reserve(krleTree, TGAWidth * TGAHeight / (2*stretchFactor));
+	KAEL_ASSERT(krleTree->width==sizeof(uint8_t), "krle_pixelsToKRLE tree must hold bytes");
+	kaelBankTree_reserve(krleTree, (uint32_t)TGAWidth * TGAHeight / (2*stretchFactor));
 
 	const uint32_t maxJump=UINT8_MAX;
 	const uint32_t maxPixelLength=15;
@@ -454,12 +500,10 @@ void krle_pixelsToKRLE(KaelTree *krleTree, const Krle_LAB *labPalette, const uin
 		printf("Wrote %d pixels into KRLE string\n",pixelCount);
 	#endif
 
-	//Null terminate
-	uint8_t *newElem = kaelTree_push(krleTree,&(uint8_t){'\0'});
+	//Null terminate. Banks have no 64 KiB limit so this only fails if allocation fails
+	uint8_t *newElem = kaelBankTree_push(krleTree,&(uint8_t){'\0'});
 	if(NULL_CHECK(newElem)){
-		//push failed due to being full
-		uint16_t lastIndex = kaelTree_length(krleTree)-1;
-		kaelTree_set(krleTree, lastIndex, &(uint8_t){'\0'} );
+		KAEL_ERROR_NOTE("krle_pixelsToKRLE out of memory, string is not terminated\n");
 	}
 }
 
@@ -547,7 +591,7 @@ uint8_t krle_runToPixels(uint8_t *TGAPixels, Krle_header header, uint8_t byte, u
 /**
  * @brief Convert KRLE null terminated byte string into 32-bit BGRA pixels
  * 
- * @note TGAPixels must have allocation of 4*width*height bytes, OR left NULL to create a new allocation of that size
+ * @note TGAPixels must have allocation of 4*width*height bytes, OR left NULL to create a new allocation of that size freed with KAEL_FREE
  */
 uint32_t krle_KRLEToPixels(const uint8_t *KRLEString, uint8_t **TGAPixels, const Krle_header header){
 	if(NULL_CHECK(KRLEString)){
@@ -559,7 +603,7 @@ uint32_t krle_KRLEToPixels(const uint8_t *KRLEString, uint8_t **TGAPixels, const
 	uint32_t px=0; //pixel index
 
 	if( *TGAPixels == NULL ){
-		*TGAPixels = calloc( 4*totalPixels, sizeof(uint8_t)); //32bits per pixel stretched by header.ratio
+		*TGAPixels = KAEL_CALLOC(KAEL_MEM_KRLE, 4*totalPixels, sizeof(uint8_t)); //32bits per pixel stretched by header.ratio
 		if(NULL_CHECK(*TGAPixels)){
 			printf("TGAPixels failed to alloc\n");
 			return 0;
@@ -15,7 +15,9 @@
 #include "kaelygon/global/kaelMacros.h"
 
 #include "kaelygon/math/math.h"
+#include "kaelygon/mem/mem.h"
 #include "kaelygon/treeMem/tree.h"
+#include "kaelygon/treeMem/bankTree.h"
 
 #include "krle/krleBase.h"
 #include "krle/krleColor.h"
@@ -34,6 +36,9 @@ typedef enum{
 	#define KRLE_EXTRA_DEBUGGING 0
 #endif
 
+//Runs packed per reserved span of KRLE string
+#define KRLE_SPAN_RUNS 256U
+
 #pragma pack(push, 1)
 typedef struct {
 	uint8_t idLength;
@@ -68,10 +73,11 @@ void krle_writeTGAFile(const char* fileName, Krle_TGAHeader TGAHeader, uint8_t *
 Krle_header krle_createKRLEHeader(uint16_t width, uint16_t height, uint32_t length, uint8_t ratio);
 Krle_header krle_readKRLEFile(const char *filePath, uint8_t **KRLEString);
 void krle_writeKRLEFile(const uint8_t *krleString, Krle_header krleHeader, const char* fileName);
+void krle_writeKRLEBanks(const KaelBankTree *krleTree, Krle_header krleHeader, const char* fileName);
 
 //KRLE<->Pixels Conversion
 uint32_t krle_KRLEToPixels(const uint8_t *KRLEString, uint8_t **TGAPixels, const Krle_header header);
-void krle_pixelsToKRLE(KaelTree *krleTree, const Krle_LAB *labPalette, const uint8_t *TGAPixels, uint16_t width, uint16_t height, uint8_t stretchFactor, uint8_t sampleType);
+void krle_pixelsToKRLE(KaelBankTree *krleTree, const Krle_LAB *labPalette, const uint8_t *TGAPixels, uint16_t width, uint16_t height, uint8_t stretchFactor, uint8_t sampleType);
 
 
 
@@ -0,0 +1,112 @@
+/**
+ * @file mapBench.c
+ *
+ * @brief Benchmark key binding lookup, KaelMap against a linear table of strcmp like compares
+ *
+ * Usage: mapBench [repeats]
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "kaelygon/global/kaelMacros.h"
+#include "kaelygon/treeMem/map.h"
+
+#define BENCH_LOOKUPS 1000000U
+#define BENCH_KEY_BYTES 8U
+#define BENCH_PRESSES 1024U //pre-built key presses cycled through
+
+uint8_t bench_press[BENCH_PRESSES][BENCH_KEY_BYTES];
+
+uint64_t bench_nowNs(){
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec*1000000000ULL + now.tv_nsec;
+}
+
+//Escape sequence like keys "\x1b[<i>~", zero padded
+void bench_key(uint8_t *key, uint16_t i){
+	memset(key, 0, BENCH_KEY_BYTES);
+	key[0] = 27;
+	key[1] = '[';
+	uint8_t length = 2;
+	do{
+		key[length++] = '0' + i%10;
+		i /= 10;
+	}while(i);
+	key[length] = '~';
+}
+
+//Compare every binding until the key matches, like the old keyMap.h table
+uint64_t bench_linear(uint16_t bindings){
+	uint8_t (*table)[BENCH_KEY_BYTES] = malloc((size_t)bindings * BENCH_KEY_BYTES);
+	if(table==NULL){return 0;}
+	for(uint16_t i=0; i<bindings; i++){
+		bench_key(table[i], i);
+	}
+
+	uint32_t found = 0;
+	uint64_t start = bench_nowNs();
+	for(uint32_t n=0; n<BENCH_LOOKUPS; n++){
+		const uint8_t *key = bench_press[n % BENCH_PRESSES];
+		for(uint16_t i=0; i<bindings; i++){
+			if(memcmp(table[i], key, BENCH_KEY_BYTES)==0){found += i; break;}
+		}
+	}
+	uint64_t elapsed = bench_nowNs() - start;
+	free(table);
+	return found ? elapsed : elapsed + 1;
+}
+
+uint64_t bench_map(uint16_t bindings){
+	KaelMap map;
+	kaelMap_alloc(&map, BENCH_KEY_BYTES, sizeof(uint16_t), bindings);
+	uint8_t key[BENCH_KEY_BYTES];
+	for(uint16_t i=0; i<bindings; i++){
+		bench_key(key, i);
+		kaelMap_set(&map, key, &i);
+	}
+
+	uint32_t found = 0;
+	uint64_t start = bench_nowNs();
+	for(uint32_t n=0; n<BENCH_LOOKUPS; n++){
+		uint16_t *value = kaelMap_get(&map, bench_press[n % BENCH_PRESSES]);
+		found += value ? *value : 0;
+	}
+	uint64_t elapsed = bench_nowNs() - start;
+	kaelMap_free(&map);
+	return found ? elapsed : elapsed + 1;
+}
+
+uint64_t bench_best(uint64_t (*func)(uint16_t), uint16_t bindings, uint16_t repeats){
+	uint32_t seed = 1;
+	for(uint16_t i=0; i<BENCH_PRESSES; i++){
+		seed = seed*1103515245U + 12345U;
+		bench_key(bench_press[i], (seed>>16) % bindings);
+	}
+
+	uint64_t best = UINT64_MAX;
+	for(uint16_t r=0; r<repeats; r++){
+		uint64_t elapsed = func(bindings);
+		best = elapsed < best ? elapsed : best;
+	}
+	return best;
+}
+
+int main(int argc, char **argv){
+	uint16_t repeats = argc>1 ? (uint16_t)atoi(argv[1]) : 5;
+	repeats = repeats ? repeats : 1;
+
+	printf("Best of %u, %u random lookups among bound keys\n", repeats, BENCH_LOOKUPS);
+	const uint16_t bindings[] = {4, 16, 64, 256};
+	for(uint8_t i=0; i<sizeof(bindings)/sizeof(bindings[0]); i++){
+		uint64_t linear = bench_best(bench_linear, bindings[i], repeats);
+		uint64_t map = bench_best(bench_map, bindings[i], repeats);
+		printf("%4u bindings  linear %7.2f ns/key  map %6.2f ns/key\n", bindings[i],
+			(double)linear/BENCH_LOOKUPS, (double)map/BENCH_LOOKUPS);
+	}
+	return 0;
+}
@@ -0,0 +1,122 @@
+/**
+ * @file poolBench.c
+ *
+ * @brief Benchmark KaelPool acquire and release against malloc and free
+ *
+ * Random churn keeps a live set of shape sized objects. Ops are timed in batches,
+ * worst batch shows how deterministic one allocation is
+ *
+ * Usage: poolBench [repeats]
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "kaelygon/global/kaelMacros.h"
+#include "kaelygon/mem/pool.h"
+#include "kaelygon/book/book.h"
+
+#define BENCH_LIVE 4000U //live set size, fits 12 index bits left by 4 generation bits
+#define BENCH_OPS 1000000U
+#define BENCH_BATCH 64U //ops per timed batch
+#define BENCH_WIDTH ((uint16_t)sizeof(KaelBook_shape))
+
+uint64_t bench_nowNs(){
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec*1000000000ULL + now.tv_nsec;
+}
+
+//xorshift so both runs churn the same slots
+uint32_t bench_rand(uint32_t *state){
+	*state ^= *state << 13;
+	*state ^= *state >> 17;
+	*state ^= *state << 5;
+	return *state;
+}
+
+typedef struct{
+	uint64_t total;
+	uint64_t worst; //slowest batch
+}Bench_result;
+
+void bench_print(const char *name, Bench_result result){
+	printf("%-12s %7.2f ns/op, worst batch %7.2f ns/op\n", name,
+		(double)result.total/BENCH_OPS, (double)result.worst/BENCH_BATCH);
+}
+
+//------ Churn ------
+
+Bench_result bench_pool(){
+	KaelPool pool;
+	kaelPool_alloc(&pool, BENCH_WIDTH, BENCH_LIVE, 4, NULL);
+	KaelPool_handle live[BENCH_LIVE];
+	for(uint16_t i=0; i<BENCH_LIVE; i++){
+		live[i] = kaelPool_acquire(&pool);
+	}
+
+	Bench_result result = {0};
+	uint32_t seed = 1;
+	for(uint32_t op=0; op<BENCH_OPS; op+=BENCH_BATCH){
+		uint64_t start = bench_nowNs();
+		for(uint32_t i=0; i<BENCH_BATCH; i+=2){
+			uint16_t pick = bench_rand(&seed) % BENCH_LIVE;
+			kaelPool_release(&pool, live[pick]);
+			live[pick] = kaelPool_acquire(&pool);
+			((uint8_t *)kaelPool_get(&pool, live[pick]))[0] = (uint8_t)i;
+		}
+		uint64_t elapsed = bench_nowNs() - start;
+		result.total += elapsed;
+		result.worst = elapsed > result.worst ? elapsed : result.worst;
+	}
+	kaelPool_free(&pool);
+	return result;
+}
+
+Bench_result bench_malloc(){
+	uint8_t *live[BENCH_LIVE];
+	for(uint16_t i=0; i<BENCH_LIVE; i++){
+		live[i] = calloc(1, BENCH_WIDTH);
+	}
+
+	Bench_result result = {0};
+	uint32_t seed = 1;
+	for(uint32_t op=0; op<BENCH_OPS; op+=BENCH_BATCH){
+		uint64_t start = bench_nowNs();
+		for(uint32_t i=0; i<BENCH_BATCH; i+=2){
+			uint16_t pick = bench_rand(&seed) % BENCH_LIVE;
+			free(live[pick]);
+			live[pick] = calloc(1, BENCH_WIDTH);
+			live[pick][0] = (uint8_t)i;
+		}
+		uint64_t elapsed = bench_nowNs() - start;
+		result.total += elapsed;
+		result.worst = elapsed > result.worst ? elapsed : result.worst;
+	}
+	for(uint16_t i=0; i<BENCH_LIVE; i++){
+		free(live[i]);
+	}
+	return result;
+}
+
+//Keep the run with the lowest total
+Bench_result bench_best(Bench_result (*func)(), uint16_t repeats){
+	Bench_result best = { .total = UINT64_MAX };
+	for(uint16_t r=0; r<repeats; r++){
+		Bench_result result = func();
+		best = result.total < best.total ? result : best;
+	}
+	return best;
+}
+
+int main(int argc, char **argv){
+	uint16_t repeats = argc>1 ? (uint16_t)atoi(argv[1]) : 5;
+	repeats = repeats ? repeats : 1;
+
+	printf("Best of %u, %u byte objects, %u live\n", repeats, BENCH_WIDTH, BENCH_LIVE);
+	bench_print("pool", bench_best(bench_pool, repeats));
+	bench_print("malloc", bench_best(bench_malloc, repeats));
+	return 0;
+}
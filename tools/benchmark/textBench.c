@@ -0,0 +1,85 @@
+/**
+ * @file textBench.c
+ *
+ * @brief Benchmark keystroke cost in the middle of growing text, KaelGapStr against a flat string memmove
+ *
+ * Usage: textBench [repeats]
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "kaelygon/global/kaelMacros.h"
+#include "kaelygon/string/gapStr.h"
+
+#define BENCH_KEYS 2000U //keystrokes per document
+
+uint64_t bench_nowNs(){
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec*1000000000ULL + now.tv_nsec;
+}
+
+//Type in the middle of a flat null terminated string, like KaelBook_shape.string
+uint64_t bench_flat(uint16_t docLength){
+	uint8_t *text = malloc(docLength + BENCH_KEYS + 1U);
+	if(text==NULL){return 0;}
+	memset(text, 'a', docLength);
+	text[docLength] = '\0';
+
+	uint16_t length = docLength;
+	uint16_t cursor = docLength/2;
+	uint64_t start = bench_nowNs();
+	for(uint16_t i=0; i<BENCH_KEYS; i++){
+		memmove(text + cursor + 1, text + cursor, length - cursor + 1U);
+		text[cursor++] = 'x';
+		length++;
+	}
+	uint64_t elapsed = bench_nowNs() - start;
+	free(text);
+	return elapsed;
+}
+
+uint64_t bench_gap(uint16_t docLength){
+	KaelGapStr gap;
+	kaelGapStr_alloc(&gap, docLength);
+	for(uint16_t i=0; i<docLength; i++){
+		kaelGapStr_insert(&gap, (const uint8_t *)"a", 1);
+	}
+	kaelGapStr_setCursor(&gap, docLength/2);
+
+	uint64_t start = bench_nowNs();
+	for(uint16_t i=0; i<BENCH_KEYS; i++){
+		kaelGapStr_insert(&gap, (const uint8_t *)"x", 1);
+	}
+	uint64_t elapsed = bench_nowNs() - start;
+	kaelGapStr_free(&gap);
+	return elapsed;
+}
+
+uint64_t bench_best(uint64_t (*func)(uint16_t), uint16_t docLength, uint16_t repeats){
+	uint64_t best = UINT64_MAX;
+	for(uint16_t r=0; r<repeats; r++){
+		uint64_t elapsed = func(docLength);
+		best = elapsed < best ? elapsed : best;
+	}
+	return best;
+}
+
+int main(int argc, char **argv){
+	uint16_t repeats = argc>1 ? (uint16_t)atoi(argv[1]) : 20;
+	repeats = repeats ? repeats : 1;
+
+	printf("Best of %u, %u keystrokes in the middle\n", repeats, BENCH_KEYS);
+	const uint16_t docLength[] = {1024, 8192, 32768, 60000};
+	for(uint8_t i=0; i<sizeof(docLength)/sizeof(docLength[0]); i++){
+		uint64_t flat = bench_best(bench_flat, docLength[i], repeats);
+		uint64_t gap = bench_best(bench_gap, docLength[i], repeats);
+		printf("%6u bytes  flat %8.2f ns/key  gap %6.2f ns/key\n", docLength[i],
+			(double)flat/BENCH_KEYS, (double)gap/BENCH_KEYS);
+	}
+	return 0;
+}
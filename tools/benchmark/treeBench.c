@@ -0,0 +1,366 @@
+/**
+ * @file treeBench.c
+ *
+ * @brief Benchmark KaelTree append, frame fill/drain and iteration paths, arena, typed, small and banked trees, deque and KRLE encoding that uses them
+ *
+ * Usage: treeBench [repeats]
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "kaelygon/global/kaelMacros.h"
+#include "kaelygon/treeMem/tree.h"
+#include "kaelygon/treeMem/typedTree.h"
+#include "kaelygon/treeMem/bankTree.h"
+#include "kaelygon/treeMem/deque.h"
+#include "kaelygon/mem/arena.h"
+#include "krle/krleTGA.h"
+
+#define BENCH_BYTES 60000U
+#define BENCH_IMAGE_WIDTH 256U
+#define BENCH_IMAGE_HEIGHT 200U
+#define BENCH_BANK_BYTES 300000U
+#define BENCH_FRAMES 200U
+#define BENCH_FRAME_SHAPES 256U
+#define BENCH_TINY_TREES 20000U
+#define BENCH_TINY_LENGTH 12U //typical drawQueue frame
+#define BENCH_LARGE_WIDTH 1600U
+#define BENCH_LARGE_HEIGHT 1200U //encodes to more than 64 KiB
+
+KAEL_TREE_DEFINE(u8, uint8_t)
+KAEL_TREE_DEFINE(ptr, void *)
+KAEL_TREE_DEFINE_SMALL(smallPtr, void *, 16)
+
+uint64_t bench_nowNs(){
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec*1000000000ULL + now.tv_nsec;
+}
+
+//------ Append paths ------
+
+uint16_t bench_push(KaelTree *tree){
+	for(uint16_t i=0; i<BENCH_BYTES; i+=2){
+		kaelTree_push(tree, &(uint8_t){KRLE_PIXEL_JUMP});
+		kaelTree_push(tree, &(uint8_t){(uint8_t)i});
+	}
+	return kaelTree_length(tree);
+}
+
+uint16_t bench_pushN(KaelTree *tree){
+	for(uint16_t i=0; i<BENCH_BYTES; i+=2){
+		kaelTree_pushN(tree, (uint8_t[]){KRLE_PIXEL_JUMP, (uint8_t)i}, 2);
+	}
+	return kaelTree_length(tree);
+}
+
+uint16_t bench_span(KaelTree *tree){
+	for(uint16_t i=0; i<BENCH_BYTES; i+=512){
+		uint8_t *span = kaelTree_reserveSpan(tree, 512);
+		uint16_t written = 0;
+		for(uint16_t j=i; j<i+512 && j<BENCH_BYTES; j+=2){
+			span[written++] = KRLE_PIXEL_JUMP;
+			span[written++] = (uint8_t)j;
+		}
+		kaelTree_commitSpan(tree, written);
+	}
+	return kaelTree_length(tree);
+}
+
+void bench_append(const char *name, uint16_t (*func)(KaelTree*), uint16_t repeats){
+	uint64_t best = UINT64_MAX;
+	uint16_t length = 0;
+	for(uint16_t r=0; r<repeats; r++){
+		KaelTree tree;
+		kaelTree_alloc(&tree, sizeof(uint8_t));
+		uint64_t start = bench_nowNs();
+		length = func(&tree);
+		uint64_t elapsed = bench_nowNs() - start;
+		best = elapsed < best ? elapsed : best;
+		kaelTree_free(&tree);
+	}
+	printf("%-12s %6u bytes %9.3f us %7.2f ns/byte\n", name, length, best/1000.0, (double)best/length);
+}
+
+//Same pushes as bench_push on a tree that grows in place inside an arena
+void bench_arena(uint16_t repeats){
+	uint64_t best = UINT64_MAX;
+	uint16_t length = 0;
+	KaelArena arena;
+	kaelArena_alloc(&arena, UINT16_MAX, NULL);
+	for(uint16_t r=0; r<repeats; r++){
+		KaelTree tree;
+		kaelTree_allocArena(&tree, sizeof(uint8_t), &arena);
+		uint64_t start = bench_nowNs();
+		length = bench_push(&tree);
+		uint64_t elapsed = bench_nowNs() - start;
+		best = elapsed < best ? elapsed : best;
+		kaelTree_free(&tree);
+		kaelArena_reset(&arena);
+	}
+	kaelArena_free(&arena);
+	printf("%-12s %6u bytes %9.3f us %7.2f ns/byte\n", "arena push", length, best/1000.0, (double)best/length);
+}
+
+//Fill and drain a queue every frame like drawQueue
+void bench_frames(const char *name, KaelTree_shrinkPolicy policy, uint16_t repeats){
+	uint64_t best = UINT64_MAX;
+	uint32_t pushes = 0;
+	for(uint16_t r=0; r<repeats; r++){
+		KaelTree tree;
+		kaelTree_alloc(&tree, sizeof(void *));
+		kaelTree_setShrink(&tree, policy);
+		pushes = 0;
+		uint64_t start = bench_nowNs();
+		for(uint16_t frame=0; frame<BENCH_FRAMES; frame++){
+			for(uint16_t i=0; i<BENCH_FRAME_SHAPES; i++){
+				kaelTree_push(&tree, &tree.data);
+			}
+			pushes += BENCH_FRAME_SHAPES;
+			while(!kaelTree_empty(&tree)){
+				kaelTree_pop(&tree);
+			}
+		}
+		uint64_t elapsed = bench_nowNs() - start;
+		best = elapsed < best ? elapsed : best;
+		kaelTree_free(&tree);
+	}
+	printf("%-12s %6u push  %9.3f us %7.2f ns/push\n", name, pushes, best/1000.0, (double)best/pushes);
+}
+
+//------ Tiny trees ------
+
+//Many short lived trees of a typical frame queue length, heap typed tree against inline storage
+void bench_tiny(uint16_t repeats){
+	uint64_t bestHeap = UINT64_MAX;
+	uint64_t bestSmall = UINT64_MAX;
+	for(uint16_t r=0; r<repeats; r++){
+		uint64_t start = bench_nowNs();
+		for(uint16_t t=0; t<BENCH_TINY_TREES; t++){
+			KaelTree_ptr tree;
+			kaelTree_ptr_alloc(&tree);
+			for(uint16_t i=0; i<BENCH_TINY_LENGTH; i++){
+				kaelTree_ptr_push(&tree, &tree);
+			}
+			kaelTree_ptr_free(&tree);
+		}
+		uint64_t elapsed = bench_nowNs() - start;
+		bestHeap = elapsed < bestHeap ? elapsed : bestHeap;
+
+		start = bench_nowNs();
+		for(uint16_t t=0; t<BENCH_TINY_TREES; t++){
+			KaelTree_smallPtr tree;
+			kaelTree_smallPtr_alloc(&tree);
+			for(uint16_t i=0; i<BENCH_TINY_LENGTH; i++){
+				kaelTree_smallPtr_push(&tree, &tree);
+			}
+			kaelTree_smallPtr_free(&tree);
+		}
+		elapsed = bench_nowNs() - start;
+		bestSmall = elapsed < bestSmall ? elapsed : bestSmall;
+	}
+	printf("%-12s %6u trees %9.3f us %7.2f ns/tree\n", "tiny heap", BENCH_TINY_TREES, bestHeap/1000.0, (double)bestHeap/BENCH_TINY_TREES);
+	printf("%-12s %6u trees %9.3f us %7.2f ns/tree\n", "tiny inline", BENCH_TINY_TREES, bestSmall/1000.0, (double)bestSmall/BENCH_TINY_TREES);
+}
+
+uint16_t bench_typedPush(KaelTree_u8 *tree){
+	for(uint16_t i=0; i<BENCH_BYTES; i+=2){
+		kaelTree_u8_push(tree, KRLE_PIXEL_JUMP);
+		kaelTree_u8_push(tree, (uint8_t)i);
+	}
+	return kaelTree_u8_length(tree);
+}
+
+void bench_typedAppend(const char *name, uint16_t (*func)(KaelTree_u8*), uint16_t repeats){
+	uint64_t best = UINT64_MAX;
+	uint16_t length = 0;
+	for(uint16_t r=0; r<repeats; r++){
+		KaelTree_u8 tree;
+		kaelTree_u8_alloc(&tree);
+		uint64_t start = bench_nowNs();
+		length = func(&tree);
+		uint64_t elapsed = bench_nowNs() - start;
+		best = elapsed < best ? elapsed : best;
+		kaelTree_u8_free(&tree);
+	}
+	printf("%-12s %6u bytes %9.3f us %7.2f ns/byte\n", name, length, best/1000.0, (double)best/length);
+}
+
+//------ Iteration ------
+
+uint16_t bench_iterNext(const KaelTree *tree, const KaelTree_u8 *typed){
+	(void)typed;
+	uint16_t sum = 0;
+	uint8_t *current = kaelTree_begin(tree);
+	while(current){
+		sum += *current;
+		kaelTree_next(tree, (void**)&current);
+	}
+	return sum;
+}
+
+uint16_t bench_iterGet(const KaelTree *tree, const KaelTree_u8 *typed){
+	(void)typed;
+	uint16_t sum = 0;
+	for(uint16_t i=0; i<kaelTree_length(tree); i++){
+		sum += *(uint8_t *)kaelTree_get(tree, i);
+	}
+	return sum;
+}
+
+uint16_t bench_iterEnd(const KaelTree *tree, const KaelTree_u8 *typed){
+	(void)typed;
+	uint16_t sum = 0;
+	uint8_t *end = kaelTree_end(tree);
+	for(uint8_t *current = tree->data; current < end; current++){
+		sum += *current;
+	}
+	return sum;
+}
+
+uint16_t bench_iterTyped(const KaelTree *tree, const KaelTree_u8 *typed){
+	(void)tree;
+	uint16_t sum = 0;
+	KAEL_TREE_FOREACH(it, typed){
+		sum += *it;
+	}
+	return sum;
+}
+
+void bench_iterate(const char *name, uint16_t (*func)(const KaelTree*, const KaelTree_u8*), uint16_t repeats){
+	KaelTree tree;
+	KaelTree_u8 typed;
+	kaelTree_alloc(&tree, sizeof(uint8_t));
+	kaelTree_u8_alloc(&typed);
+	bench_push(&tree);
+	bench_typedPush(&typed);
+
+	uint64_t best = UINT64_MAX;
+	uint16_t sum = 0;
+	for(uint16_t r=0; r<repeats; r++){
+		uint64_t start = bench_nowNs();
+		sum = func(&tree, &typed);
+		uint64_t elapsed = bench_nowNs() - start;
+		best = elapsed < best ? elapsed : best;
+	}
+	printf("%-12s %6u sum   %9.3f us %7.2f ns/byte\n", name, sum, best/1000.0, (double)best/tree.length);
+
+	kaelTree_free(&tree);
+	kaelTree_u8_free(&typed);
+}
+
+//------ Banked tree ------
+
+void bench_bank(uint16_t repeats){
+	uint64_t best = UINT64_MAX;
+	uint32_t length = 0;
+	for(uint16_t r=0; r<repeats; r++){
+		KaelBankTree tree;
+		kaelBankTree_alloc(&tree, sizeof(uint8_t));
+		uint64_t start = bench_nowNs();
+		for(uint32_t i=0; i<BENCH_BANK_BYTES; i+=2){
+			kaelBankTree_push(&tree, &(uint8_t){KRLE_PIXEL_JUMP});
+			kaelBankTree_push(&tree, &(uint8_t){(uint8_t)i});
+		}
+		uint64_t elapsed = bench_nowNs() - start;
+		best = elapsed < best ? elapsed : best;
+		length = kaelBankTree_length(&tree);
+		kaelBankTree_free(&tree);
+	}
+	printf("%-12s %6u bytes %9.3f us %7.2f ns/byte\n", "bank push", length, best/1000.0, (double)best/length);
+}
+
+void bench_deque(uint16_t repeats){
+	uint64_t best = UINT64_MAX;
+	uint32_t length = 0;
+	for(uint16_t r=0; r<repeats; r++){
+		KaelDeque deque;
+		kaelDeque_alloc(&deque, sizeof(uint8_t));
+		uint64_t start = bench_nowNs();
+		for(uint32_t i=0; i<BENCH_BANK_BYTES; i+=2){
+			kaelDeque_pushBack(&deque, &(uint8_t){KRLE_PIXEL_JUMP});
+			kaelDeque_pushBack(&deque, &(uint8_t){(uint8_t)i});
+		}
+		uint64_t elapsed = bench_nowNs() - start;
+		best = elapsed < best ? elapsed : best;
+		length = kaelDeque_length(&deque);
+		kaelDeque_free(&deque);
+	}
+	printf("%-12s %6u bytes %9.3f us %7.2f ns/byte\n", "deque push", length, best/1000.0, (double)best/length);
+}
+
+//------ KRLE encode ------
+
+/**
+ * @brief Stripes of palette colors with transparent gaps, gives both pixel and jump runs
+ */
+void bench_genImage(uint8_t *pixels, uint16_t width, uint16_t height){
+	for(uint16_t y=0; y<height; y++){
+		for(uint16_t x=0; x<width; x++){
+			uint8_t *px = &pixels[((uint32_t)y*width + x)*4];
+			uint8_t band = (x/7 + y/5) % 16;
+			Krle_RGB rgb = krle_orchisPalette[band];
+			px[0] = rgb.b;
+			px[1] = rgb.g;
+			px[2] = rgb.r;
+			px[3] = ((x/23 + y/11) % 4)==0 ? 0 : 255;
+		}
+	}
+}
+
+void bench_krle(const char *name, uint16_t width, uint16_t height, uint16_t repeats){
+	uint8_t *pixels = malloc((uint32_t)width*height*4);
+	if(pixels==NULL){return;}
+	bench_genImage(pixels, width, height);
+
+	Krle_LAB paletteLAB[KRLE_PALETTE_SIZE];
+	krle_paletteRGBToLAB(krle_orchisPalette, paletteLAB, KRLE_PALETTE_SIZE);
+
+	uint64_t best = UINT64_MAX;
+	uint32_t length = 0;
+	uint16_t hash = 0;
+	for(uint16_t r=0; r<repeats; r++){
+		KaelBankTree krleTree;
+		kaelBankTree_alloc(&krleTree, sizeof(uint8_t));
+		uint64_t start = bench_nowNs();
+		krle_pixelsToKRLE(&krleTree, paletteLAB, pixels, width, height, 1, KRLE_NEAREST);
+		uint64_t elapsed = bench_nowNs() - start;
+		best = elapsed < best ? elapsed : best;
+
+		length = kaelBankTree_length(&krleTree);
+		hash = 0;
+		for(uint32_t i=0; i<length; i++){
+			hash = kaelRand_lcg(hash ^ *(uint8_t *)kaelBankTree_get(&krleTree, i));
+		}
+		kaelBankTree_free(&krleTree);
+	}
+	free(pixels);
+	printf("%-12s %6u bytes %9.3f us, output hash %u\n", name, length, best/1000.0, hash);
+}
+
+int main(int argc, char **argv){
+	uint16_t repeats = argc>1 ? (uint16_t)atoi(argv[1]) : 50;
+	repeats = repeats ? repeats : 1;
+
+	printf("Best of %u\n", repeats);
+	bench_append("push", bench_push, repeats);
+	bench_append("pushN", bench_pushN, repeats);
+	bench_append("span", bench_span, repeats);
+	bench_arena(repeats);
+	bench_frames("frame shrink", KAEL_TREE_SHRINK_HYSTERESIS, repeats);
+	bench_frames("frame keep", KAEL_TREE_SHRINK_NEVER, repeats);
+	bench_typedAppend("typed push", bench_typedPush, repeats);
+	bench_tiny(repeats);
+	bench_iterate("iter next", bench_iterNext, repeats);
+	bench_iterate("iter get", bench_iterGet, repeats);
+	bench_iterate("iter end", bench_iterEnd, repeats);
+	bench_iterate("iter typed", bench_iterTyped, repeats);
+	bench_bank(repeats);
+	bench_deque(repeats);
+	bench_krle("krle encode", BENCH_IMAGE_WIDTH, BENCH_IMAGE_HEIGHT, repeats);
+	bench_krle("krle large", BENCH_LARGE_WIDTH, BENCH_LARGE_HEIGHT, 1);
+	return 0;
+}
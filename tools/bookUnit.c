@@ -43,8 +43,7 @@ KaelBook_shape kaelBook_genCheckerboard(uint16_t width, uint16_t height, uint16_
 	size_t byteEstimate = width*height/2 + cellsTotal*ratio[1] + 2*cellsTotal*ratio[1] + 3; 
 	kaelTree_reserve(&tmpString, byteEstimate); 
 
-	kaelTree_push(&tmpString,&(uint8_t){KRLE_TEXT_STYLE});
-	kaelTree_push(&tmpString,&blackText.byte);
+	kaelTree_pushN(&tmpString, (uint8_t[]){KRLE_TEXT_STYLE, blackText.byte}, 2);
 
 	for(uint16_t j=0; j<height; j++){
 		for(uint16_t i=0; i<width; i++){
@@ -54,8 +53,7 @@ KaelBook_shape kaelBook_genCheckerboard(uint16_t width, uint16_t height, uint16_
 			if(lastState!=state){
 				//Swap style
 				curCol.byte = state ? highCol.byte : lowCol.byte;
-				kaelTree_push(&tmpString,&(uint8_t){KRLE_TEXT_STYLE});
-				kaelTree_push(&tmpString,&curCol.byte);
+				kaelTree_pushN(&tmpString, (uint8_t[]){KRLE_TEXT_STYLE, curCol.byte}, 2);
 				KAEL_ASSERT(curCol.byte!='\0', "Illegal value");
 			}
 
@@ -68,12 +66,12 @@ KaelBook_shape kaelBook_genCheckerboard(uint16_t width, uint16_t height, uint16_
 				spaceCount+= spaceCount==0;
 				if(spaceCount>2){
 					//Printing marker is more efficient
-					kaelTree_push(&tmpString,&(uint8_t){KRLE_TEXT_SPACE});
-					kaelTree_push(&tmpString,&(uint8_t){spaceCount});
+					kaelTree_pushN(&tmpString, (uint8_t[]){KRLE_TEXT_SPACE, spaceCount}, 2);
 				}else{
 					//Pritning space is more efficient
-					for(uint16_t si=0; si<spaceCount; si++){
-						kaelTree_push(&tmpString, &(uint8_t){' '});
+					uint8_t *spaces = kaelTree_pushN(&tmpString, NULL, spaceCount);
+					if(spaces!=NULL){
+						memset(spaces, ' ', spaceCount);
 					}
 				}
 				i+=spaceCount-1;
@@ -114,6 +112,11 @@ KaelBook_shape kaelBook_genPixel(uint16_t width, uint16_t height, uint16_t col,
 	size_t pixelCount=0;
 
 	for(uint16_t j=0; j<height; j++){
+		//Row is written through a span, one resize per row
+		uint8_t *row = kaelTree_reserveSpan(&tmpString, width);
+		if(row==NULL){break;}
+		uint16_t written = 0;
+
 		for(uint16_t i=0; i<width; i++){
 			mixByte+=0b00010000; //Increment colors place
 
@@ -122,11 +125,12 @@ KaelBook_shape kaelBook_genPixel(uint16_t width, uint16_t height, uint16_t col,
 			pixel.length = pixelLength ? pixelLength : pixel.length;
 
 			pixelCount+=pixel.length;
-			kaelTree_push(&tmpString,&(uint8_t){pixel.byte});
+			row[written++] = pixel.byte;
 			KAEL_ASSERT(pixel.byte!='\0', "Illegal value");
 			
 			if(pixelCount>=width*height){break;}
 		}
+		kaelTree_commitSpan(&tmpString, written);
 	}
 	//Null terminate
 	kaelTree_push(&tmpString,'\0');
@@ -146,26 +150,30 @@ KaelBook_page kaelBook_genTestPage(uint16_t bookWidth, uint16_t bookHeight){
 	uint16_t checkerWidth  = 32;
 	uint16_t checkerHeight = 16;
 	KaelBook_shape checkerBoard = kaelBook_genCheckerboard(checkerWidth, checkerHeight, 0,0, (uint16_t[2]){4,2});
-	kaelTree_push(&testPage.shape, &checkerBoard);
+	kaelDeque_pushBack(&testPage.shape, &checkerBoard);
 	checkerBoard.ownsString=0; //Keep track of ownership to avoid double free
 
 	checkerBoard.pos[0] = bookWidth	- checkerWidth;
 	checkerBoard.pos[1] = bookHeight	- checkerHeight;
-	kaelTree_push(&testPage.shape, &checkerBoard);
+	kaelDeque_pushBack(&testPage.shape, &checkerBoard);
 
-	KaelBook_shape *firstShape = kaelTree_begin(&testPage.shape);
+	KaelBook_shape *firstShape = kaelDeque_front(&testPage.shape);
 	uint16_t pixelDrawCol = firstShape->pos[0] + firstShape->size[0];
 	uint16_t pixelDrawWidth  = bookWidth	- checkerWidth;
 	uint16_t pixelDrawHeight = checkerHeight;
 	KaelBook_shape pixelDraw = kaelBook_genPixel(pixelDrawWidth, pixelDrawHeight, pixelDrawCol, 0, 2);
-	kaelTree_push(&testPage.shape, &pixelDraw);
+	kaelDeque_pushBack(&testPage.shape, &pixelDraw);
 
 	return testPage;
 }
 
 void unit_kaelBook_scramblePixels(KaelBook *book){
-	KaelBook_shape *shapePtr = kaelBook_getShapeAt(book, 48, 0); //get shape at 48,0
-	if(shapePtr!=NULL && shapePtr->drawMode==drawMode_pixel){
+	KaelBook_shapeId shapeId = kaelBook_getShapeAt(book, 48, 0); //get shape at 48,0
+	if(shapeId==KAEL_BOOK_NO_SHAPE){
+		return;
+	}
+	KaelBook_shape *shapePtr = kaelBook_getShape(book, shapeId);
+	if(shapePtr->drawMode==drawMode_pixel){
 		//Scramble data
 		uint8_t *readHead = shapePtr->string;
 		while(readHead[0]){
@@ -186,7 +194,7 @@ void unit_kaelBook_scramblePixels(KaelBook *book){
 			}
 		}
 		//add to draw queue
-		kaelTree_push(&book->drawQueue, &shapePtr);
+		kaelBook_queueShape(book, shapeId);
 	}
 }
 
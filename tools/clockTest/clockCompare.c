@@ -0,0 +1,94 @@
+/**
+ * @file clockCompare.c
+ *
+ * @brief Compare CPU usage and wake up jitter of clock sleep variants
+ *
+ * Each variant sleeps one audio buffer at a time like kaelClock_sync. Wake up error is measured against CLOCK_MONOTONIC,
+ * CPU usage from getrusage. rdtsc is calibrated first, without invariant TSC it runs at CLOCK_SPEED_HZ guess
+ *
+ * Usage: clockCompare [ticks]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#include "kaelygon/global/kaelMacros.h"
+#include "kaelygon/clock/variant/rdtscClock.h"
+#include "kaelygon/clock/variant/hybridClock.h"
+
+#define COMPARE_TICKS_DEFAULT 256U
+
+typedef void (*ClockCompare_sleepFunc)(ktime_t sleepTime);
+
+typedef struct{
+	const char *name;
+	ClockCompare_sleepFunc sleep;
+}ClockCompare_variant;
+
+int64_t compare_nowNs(){
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (int64_t)now.tv_sec*1000000000LL + now.tv_nsec;
+}
+
+int64_t compare_cpuNs(){
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return ((int64_t)usage.ru_utime.tv_sec + usage.ru_stime.tv_sec)*1000000000LL
+		+ ((int64_t)usage.ru_utime.tv_usec + usage.ru_stime.tv_usec)*1000LL;
+}
+
+void compare_run(const ClockCompare_variant *variant, uint16_t ticks){
+	const ktime_t ticksPerBuffer = TARGET_CLOCK_HZ / (AUDIO_SAMPLE_RATE/AUDIO_BUFFER_SIZE);
+	const int64_t expectedNs = (int64_t)ticksPerBuffer*1000000000LL/TARGET_CLOCK_HZ;
+
+	int64_t errSum = 0;
+	int64_t errMax = 0;
+	int64_t errMin = INT64_MAX;
+
+	int64_t cpuStart = compare_cpuNs();
+	int64_t wallStart = compare_nowNs();
+
+	for(uint16_t i=0; i<ticks; i++){
+		int64_t sleepStart = compare_nowNs();
+		variant->sleep(ticksPerBuffer);
+		int64_t err = compare_nowNs() - sleepStart - expectedNs;
+
+		errSum += err<0 ? -err : err;
+		errMax = err>errMax ? err : errMax;
+		errMin = err<errMin ? err : errMin;
+	}
+
+	int64_t wall = compare_nowNs() - wallStart;
+	int64_t cpu = compare_cpuNs() - cpuStart;
+
+	printf("%-8s cpu %6.2f%%  wake error mean %8.2f us  min %8.2f us  max %8.2f us\n",
+		variant->name,
+		100.0*(double)cpu/(double)wall,
+		(double)errSum/ticks/1000.0,
+		(double)errMin/1000.0,
+		(double)errMax/1000.0
+	);
+}
+
+int main(int argc, char **argv){
+	uint16_t ticks = argc>1 ? (uint16_t)atoi(argv[1]) : COMPARE_TICKS_DEFAULT;
+	ticks = ticks==0 ? 1 : ticks;
+
+	const ClockCompare_variant variant[] = {
+		{ "rdtsc",  kaelClock_rdtsc_sleep },
+		{ "hybrid", kaelClock_hybrid_sleep },
+	};
+
+	if( kaelClock_rdtsc_calibrate() != KAEL_SUCCESS ){
+		printf("TSC isn't invariant, rdtsc uses CLOCK_SPEED_HZ %u\n", CLOCK_SPEED_HZ);
+	}
+	printf("%u ticks of %u samples at %u Hz\n", ticks, AUDIO_BUFFER_SIZE, AUDIO_SAMPLE_RATE);
+	for(uint8_t v=0; v<sizeof(variant)/sizeof(variant[0]); v++){
+		compare_run(&variant[v], ticks);
+	}
+	return 0;
+}
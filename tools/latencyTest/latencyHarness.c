@@ -0,0 +1,248 @@
+/**
+ * @file latencyHarness.c
+ *
+ * @brief Measure input to sound latency through the whole pipeline
+ *
+ * Synthetic key presses are written to a pipe that replaces stdin, so they go through kaelTui_getKeyPressStr
+ * the same way as real keys. The UI loop turns them into commands, the audio thread mixes them and
+ * the null backend reports when the first non-silent sample would leave the speaker.
+ *
+ * Usage: latencyHarness [trials] [bufferCount] [raw PCM output path]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "kaelygon/global/kaelMacros.h"
+#include "kaelygon/clock/clock.h"
+#include "kaelygon/terminal/terminal.h"
+#include "kaelygon/string/string.h"
+#include "kaelygon/audio/mixer.h"
+#include "kaelygon/audio/voice.h"
+#include "kaelygon/audio/nullBackend.h"
+
+#define LATENCY_TRIALS_DEFAULT 64U
+#define LATENCY_BUFFERS_DEFAULT 2U
+#define LATENCY_ONSET_THRESHOLD 4U
+#define LATENCY_TIMEOUT_NS 1000000000ULL
+
+#define KEY_NOTE_ON "a"
+#define KEY_NOTE_OFF "s"
+
+typedef struct{
+	KaelAudio_mixer mixer;
+	KaelAudio_commandQueue queue;
+	KaelAudio_voice voice;
+	KaelAudio_nullBackend backend;
+
+	int pipeWrite; //injected key presses, read end is stdin
+	uint16_t trials;
+	uint64_t *latencyNs; //one per trial, 0 = no sound within LATENCY_TIMEOUT_NS
+	_Atomic uint8_t quit;
+}LatencyHarness;
+
+
+
+
+//------ Audio thread ------
+
+void *latency_audioLoop(void *arg){
+	LatencyHarness *harness = arg;
+	uint8_t block[AUDIO_BUFFER_SIZE];
+
+	while(!atomic_load(&harness->quit)){
+		kaelAudio_mixQueued(&harness->mixer, &harness->queue, block, AUDIO_BUFFER_SIZE);
+		kaelAudio_writeNullBackend(&harness->backend, block, AUDIO_BUFFER_SIZE);
+	}
+	return NULL;
+}
+
+
+
+
+//------ Injector thread ------
+
+void latency_sleepMs(uint16_t ms){
+	struct timespec wait = { .tv_sec = ms/1000, .tv_nsec = (ms%1000)*1000000L };
+	nanosleep(&wait, NULL);
+}
+
+/**
+ * @brief Press note key at random phase relative to UI ticks and audio blocks, wait for sound, release
+ */
+void *latency_injectLoop(void *arg){
+	LatencyHarness *harness = arg;
+	srand(1);
+
+	for(uint16_t t=0; t<harness->trials; t++){
+		latency_sleepMs(20 + rand()%30);
+
+		kaelAudio_armOnset(&harness->backend, LATENCY_ONSET_THRESHOLD);
+		uint64_t pressNs = kaelAudio_monotonicNs();
+		if( write(harness->pipeWrite, KEY_NOTE_ON, strlen(KEY_NOTE_ON)) < 0 ){
+			break;
+		}
+
+		uint64_t onsetNs = 0;
+		while( !kaelAudio_getOnset(&harness->backend, &onsetNs) ){
+			if(kaelAudio_monotonicNs() - pressNs > LATENCY_TIMEOUT_NS){
+				onsetNs = 0;
+				break;
+			}
+			latency_sleepMs(1);
+		}
+		harness->latencyNs[t] = onsetNs > pressNs ? onsetNs - pressNs : 0;
+
+		//Onset time is in the future until the queued blocks drain, let it play before release
+		while(kaelAudio_monotonicNs() < onsetNs){
+			latency_sleepMs(1);
+		}
+		if( write(harness->pipeWrite, KEY_NOTE_OFF, strlen(KEY_NOTE_OFF)) < 0 ){
+			break;
+		}
+	}
+
+	atomic_store(&harness->quit, 1);
+	return NULL;
+}
+
+
+
+
+//------ Report ------
+
+int latency_compare(const void *a, const void *b){
+	uint64_t x = *(const uint64_t*)a;
+	uint64_t y = *(const uint64_t*)b;
+	return (x > y) - (x < y);
+}
+
+double latency_percentileMs(const uint64_t *sorted, uint16_t count, uint8_t percent){
+	uint16_t index = ((uint32_t)(count-1)*percent + 50) / 100;
+	return (double)sorted[index] / 1000000.0;
+}
+
+void latency_report(LatencyHarness *harness, uint8_t bufferCount){
+	uint16_t count = 0;
+	for(uint16_t t=0; t<harness->trials; t++){
+		if(harness->latencyNs[t]!=0){
+			harness->latencyNs[count] = harness->latencyNs[t];
+			count++;
+		}
+	}
+
+	printf("Latency over %u/%u trials, %u samples/block, %u blocks queued\n",
+		count, harness->trials, AUDIO_BUFFER_SIZE, bufferCount);
+	if(count==0){
+		printf("No sound detected\n");
+		return;
+	}
+
+	qsort(harness->latencyNs, count, sizeof(uint64_t), latency_compare);
+	printf("p50 %7.3f ms\n", latency_percentileMs(harness->latencyNs, count, 50));
+	printf("p90 %7.3f ms\n", latency_percentileMs(harness->latencyNs, count, 90));
+	printf("p99 %7.3f ms\n", latency_percentileMs(harness->latencyNs, count, 99));
+	printf("max %7.3f ms\n", (double)harness->latencyNs[count-1] / 1000000.0);
+	printf("Backend underruns %u\n", harness->backend.underruns);
+}
+
+
+
+
+//------ UI thread ------
+
+/**
+ * @brief Same shape as an interactive loop: poll keys, push commands, sleep till next tick
+ */
+void latency_uiLoop(LatencyHarness *harness){
+	KaelStr keyStr;
+	kaelStr_alloc(&keyStr, 8);
+
+	KaelClock clock;
+	kaelClock_init(&clock);
+
+	while(!atomic_load(&harness->quit)){
+		kaelTui_getKeyPressStr(&keyStr);
+
+		if(kaelStr_getEnd(&keyStr)){
+			KaelAudio_command cmd = {
+				.time = kaelAudio_getQueueTime(&harness->queue), //as soon as possible
+				.track = 0,
+			};
+			uint8_t isNote = 1;
+			if( kaelStr_compareCstr(&keyStr, KEY_NOTE_ON)==0 ){
+				cmd.type = KAEL_CMD_NOTE_ON;
+				cmd.value = 32;
+			}else if( kaelStr_compareCstr(&keyStr, KEY_NOTE_OFF)==0 ){
+				cmd.type = KAEL_CMD_NOTE_OFF;
+			}else{
+				isNote = 0;
+			}
+			if(isNote){
+				kaelAudio_pushCommand(&harness->queue, &cmd);
+			}
+			kaelStr_clear(&keyStr);
+		}
+
+		kaelClock_sync(&clock);
+	}
+
+	kaelStr_free(&keyStr);
+}
+
+
+
+
+int main(int argc, char **argv){
+	LatencyHarness harness = {0};
+	harness.trials = argc>1 ? (uint16_t)atoi(argv[1]) : LATENCY_TRIALS_DEFAULT;
+	uint8_t bufferCount = argc>2 ? (uint8_t)atoi(argv[2]) : LATENCY_BUFFERS_DEFAULT;
+	const char *path = argc>3 ? argv[3] : NULL;
+	harness.trials = kaelMath_max(harness.trials, 1);
+
+	harness.latencyNs = calloc(harness.trials, sizeof(uint64_t));
+	if(NULL_CHECK(harness.latencyNs)){return 1;}
+
+	//Replace stdin with a pipe so injected keys take the same path as typed ones
+	int fds[2];
+	if( pipe(fds) != 0 || dup2(fds[0], STDIN_FILENO) < 0 ){
+		KAEL_ERROR_NOTE("latencyHarness pipe failed\n");
+		return 1;
+	}
+	close(fds[0]);
+	fcntl(STDIN_FILENO, F_SETFL, fcntl(STDIN_FILENO, F_GETFL) | O_NONBLOCK);
+	harness.pipeWrite = fds[1];
+
+	kaelAudio_initQueue(&harness.queue);
+	kaelAudio_allocMixer(&harness.mixer, AUDIO_BUFFER_SIZE, 1);
+	kaelAudio_allocVoice(&harness.voice);
+	kaelAudio_addTrack(&harness.mixer, kaelAudio_renderVoice, &harness.voice);
+	kaelAudio_setTrackApply(&harness.mixer, 0, kaelAudio_applyVoice);
+	if( kaelAudio_openNullBackend(&harness.backend, AUDIO_BUFFER_SIZE, bufferCount, path) != KAEL_SUCCESS ){
+		return 1;
+	}
+
+	pthread_t audioThread, injectThread;
+	pthread_create(&audioThread, NULL, latency_audioLoop, &harness);
+	pthread_create(&injectThread, NULL, latency_injectLoop, &harness);
+
+	latency_uiLoop(&harness);
+
+	pthread_join(injectThread, NULL);
+	pthread_join(audioThread, NULL);
+
+	latency_report(&harness, bufferCount);
+
+	kaelAudio_closeNullBackend(&harness.backend);
+	kaelAudio_freeVoice(&harness.voice);
+	kaelAudio_freeMixer(&harness.mixer);
+	close(harness.pipeWrite);
+	free(harness.latencyNs);
+	return 0;
+}
@@ -0,0 +1,218 @@
+/**
+ * @file kaelAudioUnit.h
+ *
+ * @brief Audio mixer, command queue, effects bus and adaptive latency unit test
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "kaelygon/global/kaelMacros.h"
+
+#include "kaelygon/audio/effect.h"
+#include "kaelygon/audio/mixer.h"
+#include "kaelygon/audio/command.h"
+#include "kaelygon/audio/voice.h"
+#include "kaelygon/audio/adaptive.h"
+
+/**
+ * @brief Send an impulse through an echo bus. Echoes should repeat every delay samples and decay by feedback
+ */
+void kaelAudio_effect_unit(){
+	const uint16_t blockSize = 256;
+	const uint16_t delaySamples = 100;
+
+	KaelAudio_delay delay;
+	KaelAudio_bus bus;
+	kaelAudio_allocDelay(&delay, delaySamples, UINT16_MAX/2);
+	kaelAudio_allocBus(&bus, blockSize);
+	kaelAudio_addBusEffect(&bus, kaelAudio_processDelay, &delay);
+
+	uint8_t block[256];
+	uint8_t echo[6] = {0}; //2 blocks fit 5 echoes after the impulse
+	uint8_t failed = 0;
+
+	for(uint16_t b=0; b<2; b++){
+		memset(block, KAEL_AUDIO_SILENCE, blockSize);
+		if(b==0){
+			block[0] = UINT8_MAX; //impulse
+		}
+
+		kaelAudio_processBus(&bus, block, blockSize);
+
+		for(uint16_t i=0; i<blockSize; i++){
+			uint16_t sampleIndex = b*blockSize + i;
+			uint8_t isEchoPos = sampleIndex%delaySamples == 0;
+			if(isEchoPos){
+				echo[sampleIndex/delaySamples] = block[i];
+			}else if(sampleIndex!=0 && block[i]!=KAEL_AUDIO_SILENCE){
+				failed = 1; //Only impulse and echoes are allowed
+			}
+		}
+	}
+
+	//Impulse is dry, every echo is quieter than the previous
+	failed |= echo[0] != UINT8_MAX;
+	for(uint8_t i=1; i<6; i++){
+		failed |= echo[i] <= KAEL_AUDIO_SILENCE;
+		failed |= i>1 && echo[i] >= echo[i-1];
+	}
+	printf("echo %u %u %u %u %u %u\n", echo[0], echo[1], echo[2], echo[3], echo[4], echo[5]);
+	printf(failed ? "FAIL! Unexpected echo\n" : "Success! Echo decays\n");
+
+	kaelAudio_freeBus(&bus);
+	kaelAudio_freeDelay(&delay);
+
+	printf("kaelAudio_effect_unit Done\n");
+}
+
+typedef struct{
+	uint8_t phase;
+	uint8_t step;
+}unitTest_sawTrack;
+
+//KaelAudio_renderFunc, quiet saw wave
+void unitTest_renderSaw(void *state, uint8_t *block, uint16_t length){
+	unitTest_sawTrack *saw = state;
+	for(uint16_t i=0; i<length; i++){
+		block[i] = KAEL_AUDIO_SILENCE - 16 + (saw->phase>>3);
+		saw->phase += saw->step;
+	}
+}
+
+/**
+ * @brief Mix same tracks on the calling thread and on worker threads. Output must be bit-identical
+ */
+void kaelAudio_mixer_unit(){
+	const uint16_t blockSize = 256;
+	const uint8_t trackCount = 12;
+	const uint8_t blockCount = 8;
+	uint8_t groupCount[2] = {1, KAEL_MIXER_GROUPS_MAX};
+	uint8_t out[2][8*256];
+
+	for(uint8_t run=0; run<2; run++){
+		unitTest_sawTrack saw[12];
+		KaelAudio_mixer mixer;
+		kaelAudio_allocMixer(&mixer, blockSize, groupCount[run]);
+
+		for(uint8_t t=0; t<trackCount; t++){
+			saw[t] = (unitTest_sawTrack){ .phase = t*19, .step = t+1 };
+			kaelAudio_addTrack(&mixer, unitTest_renderSaw, &saw[t]);
+		}
+
+		for(uint8_t b=0; b<blockCount; b++){
+			kaelAudio_mixBlock(&mixer, &out[run][b*blockSize], blockSize);
+		}
+		printf("Mixed %u tracks with %u render groups\n", kaelAudio_getTrackCount(&mixer), mixer.groupCount);
+		kaelAudio_freeMixer(&mixer);
+	}
+
+	uint8_t isEqual = memcmp(out[0], out[1], sizeof(out[0]))==0;
+	printf(isEqual ? "Success! Threaded mix is bit-identical\n" : "FAIL! Threaded mix differs\n");
+
+	printf("kaelAudio_mixer_unit Done\n");
+}
+
+//KaelAudio_renderFunc, constant level
+void unitTest_renderLevel(void *state, uint8_t *block, uint16_t length){
+	memset(block, *(uint8_t *)state, length);
+}
+
+//KaelAudio_applyFunc, volume command sets level
+void unitTest_applyLevel(void *state, const KaelAudio_command *cmd){
+	if(cmd->type==KAEL_CMD_VOLUME){
+		*(uint8_t *)state = cmd->value;
+	}
+}
+
+/**
+ * @brief Queued commands have to land on their exact sample, even in the middle of a block
+ */
+void kaelAudio_command_unit(){
+	const uint16_t blockSize = 256;
+	uint8_t failed = 0;
+
+	KaelAudio_commandQueue queue;
+	kaelAudio_initQueue(&queue);
+
+	KaelAudio_mixer mixer;
+	kaelAudio_allocMixer(&mixer, blockSize, 1);
+
+	uint8_t level = KAEL_AUDIO_SILENCE;
+	kaelAudio_addTrack(&mixer, unitTest_renderLevel, &level);
+	kaelAudio_setTrackApply(&mixer, 0, unitTest_applyLevel);
+
+	KaelAudio_voice voice;
+	kaelAudio_allocVoice(&voice);
+	kaelAudio_addTrack(&mixer, kaelAudio_renderVoice, &voice);
+	kaelAudio_setTrackApply(&mixer, 1, kaelAudio_applyVoice);
+
+	uint8_t out[256];
+
+	//Commands in mid block and in the next block
+	uint16_t now = kaelAudio_getQueueTime(&queue);
+	kaelAudio_pushCommand(&queue, &(KaelAudio_command){ .time = now+37, .type = KAEL_CMD_VOLUME, .track = 0, .value = 150 });
+	kaelAudio_pushCommand(&queue, &(KaelAudio_command){ .time = now+blockSize+5, .type = KAEL_CMD_VOLUME, .track = 0, .value = 100 });
+
+	kaelAudio_mixQueued(&mixer, &queue, out, blockSize);
+	failed |= out[36]!=KAEL_AUDIO_SILENCE || out[37]!=150 || out[blockSize-1]!=150;
+
+	kaelAudio_mixQueued(&mixer, &queue, out, blockSize);
+	failed |= out[4]!=150 || out[5]!=100;
+
+	//Late command is applied at block start
+	kaelAudio_pushCommand(&queue, &(KaelAudio_command){ .time = now, .type = KAEL_CMD_VOLUME, .track = 0, .value = KAEL_AUDIO_SILENCE });
+	kaelAudio_pushCommand(&queue, &(KaelAudio_command){ .time = now, .type = KAEL_CMD_NOTE_ON, .track = 1, .value = 20 });
+	kaelAudio_mixQueued(&mixer, &queue, out, blockSize);
+
+	uint8_t isSilent = 1;
+	for(uint16_t i=0; i<blockSize; i++){
+		isSilent &= out[i]==KAEL_AUDIO_SILENCE;
+	}
+	failed |= isSilent;
+
+	printf(failed ? "FAIL! Command landed on wrong sample\n" : "Success! Commands are sample accurate\n");
+
+	kaelAudio_freeMixer(&mixer);
+	kaelAudio_freeVoice(&voice);
+
+	printf("kaelAudio_command_unit Done\n");
+}
+
+/**
+ * @brief Simulated underruns must raise latency right away, quiet playback lowers it back slowly
+ */
+void kaelAudio_adaptive_unit(){
+	const uint16_t blockSize = 256;
+	uint8_t failed = 0;
+
+	KaelAudio_adaptive adaptive;
+	kaelAudio_initAdaptive(&adaptive, blockSize, 2, 8);
+	failed |= kaelAudio_getBufferCount(&adaptive)!=2;
+
+	//Slow machine, every 10th block underruns
+	for(uint16_t i=0; i<100; i++){
+		kaelAudio_updateAdaptive(&adaptive, i%10==0, blockSize/2);
+	}
+	uint8_t grownCount = kaelAudio_getBufferCount(&adaptive);
+	failed |= grownCount <= 2;
+	kaelAudio_printAdaptive(&adaptive);
+
+	//Machine has headroom again
+	for(uint16_t i=0; i<KAEL_ADAPTIVE_WINDOW*(KAEL_ADAPTIVE_SHRINK_WINDOWS+1); i++){ //+1 for the window that saw underruns
+		kaelAudio_updateAdaptive(&adaptive, 0, blockSize/8);
+	}
+	failed |= kaelAudio_getBufferCount(&adaptive) != grownCount-1;
+	kaelAudio_printAdaptive(&adaptive);
+
+	//Fixed mode ignores measurements
+	kaelAudio_setAdaptiveMode(&adaptive, 0, 4);
+	kaelAudio_updateAdaptive(&adaptive, 1, blockSize);
+	failed |= kaelAudio_getBufferCount(&adaptive)!=4;
+
+	printf(failed ? "FAIL! Unexpected buffer count\n" : "Success! Buffer count follows underruns\n");
+	printf("kaelAudio_adaptive_unit Done\n");
+}
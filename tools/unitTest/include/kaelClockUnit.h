@@ -0,0 +1,110 @@
+/**
+ * @file kaelClockUnit.h
+ * 
+ * @brief Test clock variants
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "kaelygon/global/kaelMacros.h"
+#include "kaelygon/clock/clock.h"
+
+uint64_t unitTest_clockNowNs(){
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec*1000000000ULL + now.tv_nsec;
+}
+
+void kaelClock_calibrate_unit(){
+	uint8_t failed = 0;
+
+	uint64_t startNs = unitTest_clockNowNs();
+	uint8_t variant = kaelClock_selectVariant();
+	uint64_t selectNs = unitTest_clockNowNs() - startNs;
+
+	printf("Clock variant %s, selected in %.2f ms\n", variant==KAEL_CLOCK_RDTSC ? "rdtsc" : "hybrid", (double)selectNs/1000000.0);
+	if(variant==KAEL_CLOCK_RDTSC){
+		printf("TSC %llu Hz\n", kaelClock_rdtsc_getRatio()*TARGET_CLOCK_HZ);
+	}
+	failed |= selectNs > 50000000ULL;
+
+	//Sleep 1/8 second and compare to monotonic clock
+	const ktime_t sleepTicks = TARGET_CLOCK_HZ/8;
+	const uint64_t expectedNs = 125000000ULL;
+	startNs = unitTest_clockNowNs();
+	kaelClock_sleep(sleepTicks);
+	uint64_t sleptNs = unitTest_clockNowNs() - startNs;
+
+	printf("Slept %.3f ms, expected %.3f ms\n", (double)sleptNs/1000000.0, (double)expectedNs/1000000.0);
+	//Calibrated against CLOCK_MONOTONIC_RAW over 20 ms, measured here with CLOCK_MONOTONIC which NTP slews up to 500 ppm
+	failed |= sleptNs + expectedNs/1000 < expectedNs || sleptNs > expectedNs + expectedNs/20;
+
+	printf("%s\n", failed ? "FAIL!" : "Success!");
+	printf("kaelClock_calibrate_unit Done\n");
+}
+
+void kaelClock_virtual_unit(){
+	uint8_t failed = 0;
+	uint8_t realVariant = kaelClock_getVariant();
+	failed |= kaelClock_setVariant(KAEL_CLOCK_VIRTUAL) != KAEL_SUCCESS;
+
+	KaelClock clock;
+	kaelClock_init(&clock);
+
+	//17 minutes of ticks, tickLow wraps twice
+	const uint32_t tickCount = 2UL*UINT16_MAX + 1000;
+	uint64_t startNs = unitTest_clockNowNs();
+	for(uint32_t i=0; i<tickCount; i++){
+		ktime_t before = kaelClock_time();
+		kaelClock_sync(&clock);
+		failed |= (ktime_t)(kaelClock_time() - before) != clock.ticksPerBuffer; //every tick is exactly one buffer
+	}
+	uint64_t elapsedNs = unitTest_clockNowNs() - startNs;
+
+	failed |= kaelClock_getTickHigh(&clock) != tickCount>>16;
+	failed |= kaelClock_getTick(&clock) != (uint16_t)tickCount;
+	printf("%lu virtual ticks (%lu s) in %.3f ms\n", (unsigned long)tickCount, (unsigned long)(tickCount/clock.tickRate), (double)elapsedNs/1000000.0);
+
+	if(realVariant!=KAEL_CLOCK_UNSET){
+		kaelClock_setVariant(realVariant);
+	}
+	printf("%s\n", failed ? "FAIL!" : "Success!");
+	printf("kaelClock_virtual_unit Done\n");
+}
+
+/**
+ * @brief Stall the loop for a few buffers. Without drift correction the lost time would never be recovered
+ */
+void kaelClock_drift_unit(){
+	uint8_t failed = 0;
+
+	KaelClock clock;
+	kaelClock_init(&clock);
+
+	const uint16_t tickCount = 64;
+	for(uint16_t i=0; i<tickCount; i++){
+		if(i==8){
+			uint64_t stallStart = unitTest_clockNowNs();
+			while(unitTest_clockNowNs() - stallStart < 3ULL*clock.periodNs){}
+		}
+		kaelClock_sync(&clock);
+	}
+
+	KaelClock_stats stats;
+	kaelClock_getStats(&clock, &stats);
+	printf("Phase error %.3f ms, last lateness %.3f ms, max lateness %.3f ms, jitter %.3f ms, overruns %u, slips %u\n",
+		stats.phaseErrorNs/1000000.0, stats.lastLatenessNs/1000000.0, stats.maxLatenessNs/1000000.0,
+		stats.jitterNs/1000000.0, stats.overruns, stats.slips);
+
+	failed |= kaelClock_getTick64(&clock) != tickCount;
+	failed |= stats.overruns == 0;
+	failed |= stats.maxLatenessNs < (int32_t)clock.periodNs; //stall was seen
+	failed |= stats.lastLatenessNs > (int32_t)clock.periodNs/8 || stats.lastLatenessNs < -(int32_t)clock.periodNs/8; //and caught up
+
+	printf("%s\n", failed ? "FAIL!" : "Success!");
+	printf("kaelClock_drift_unit Done\n");
+}
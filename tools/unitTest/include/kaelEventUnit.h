@@ -0,0 +1,107 @@
+/**
+ * @file kaelEventUnit.h
+ * 
+ * @brief Test epoll event loop with timer, pipe and SIGWINCH sources
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/resource.h>
+#include <sys/epoll.h>
+
+#include "kaelygon/global/kaelMacros.h"
+#include "kaelygon/event/eventLoop.h"
+
+typedef struct{
+	KaelEvent_loop *loop;
+	int pipeFd[2];
+	uint64_t ticks;
+	uint64_t sentNs;
+	uint64_t receivedNs;
+	uint8_t resizes;
+	uint8_t raised; //SIGWINCH sent
+}UnitTest_eventState;
+
+uint64_t unitTest_eventNowNs(){
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec*1000000000ULL + now.tv_nsec;
+}
+
+void unitTest_eventTick(void *state, uint64_t ticks){
+	UnitTest_eventState *test = state;
+	test->ticks += ticks; //expirations coalesce under load, so thresholds are crossed rather than hit
+
+	if(test->ticks >= 10 && test->sentNs==0){
+		test->sentNs = unitTest_eventNowNs();
+		if( write(test->pipeFd[1], "k", 1) != 1 ){
+			test->sentNs = 0;
+		}
+	}
+	if(test->ticks >= 20 && !test->raised){
+		test->raised = 1;
+		raise(SIGWINCH);
+	}
+	if(test->ticks >= 32){
+		kaelEvent_stop(test->loop);
+	}
+}
+
+void unitTest_eventRead(void *state, int fd, uint32_t events __attribute__((unused))){
+	UnitTest_eventState *test = state;
+	char key;
+	if( read(fd, &key, 1) == 1 ){
+		test->receivedNs = unitTest_eventNowNs();
+	}
+}
+
+void unitTest_eventResize(void *state){
+	UnitTest_eventState *test = state;
+	test->resizes++;
+}
+
+void kaelEvent_unit(){
+	uint8_t failed = 0;
+
+	KaelEvent_loop loop;
+	UnitTest_eventState test = { .loop = &loop };
+	failed |= pipe(test.pipeFd) != 0;
+
+	failed |= kaelEvent_alloc(&loop) != KAEL_SUCCESS;
+	uint32_t periodNs = (uint64_t)AUDIO_BUFFER_SIZE*1000000000ULL/AUDIO_SAMPLE_RATE;
+	failed |= kaelEvent_setTimer(&loop, periodNs, unitTest_eventTick, &test) != KAEL_SUCCESS;
+	failed |= kaelEvent_addFd(&loop, test.pipeFd[0], EPOLLIN, unitTest_eventRead, &test) != KAEL_SUCCESS;
+	failed |= kaelEvent_watchResize(&loop, unitTest_eventResize, &test) != KAEL_SUCCESS;
+
+	struct rusage usageStart, usageEnd;
+	getrusage(RUSAGE_SELF, &usageStart);
+	uint64_t startNs = unitTest_eventNowNs();
+
+	kaelEvent_run(&loop);
+
+	uint64_t wallNs = unitTest_eventNowNs() - startNs;
+	getrusage(RUSAGE_SELF, &usageEnd);
+	uint64_t cpuNs = ((usageEnd.ru_utime.tv_sec - usageStart.ru_utime.tv_sec) + (usageEnd.ru_stime.tv_sec - usageStart.ru_stime.tv_sec))*1000000000ULL
+		+ ((usageEnd.ru_utime.tv_usec - usageStart.ru_utime.tv_usec) + (usageEnd.ru_stime.tv_usec - usageStart.ru_stime.tv_usec))*1000LL;
+
+	uint64_t reactNs = test.receivedNs - test.sentNs;
+	printf("%lu ticks in %.3f ms, cpu %.2f%%, fd reaction %.3f ms, resizes %u\n",
+		(unsigned long)test.ticks, wallNs/1000000.0, 100.0*cpuNs/wallNs, reactNs/1000000.0, test.resizes);
+
+	failed |= test.ticks < 32;
+	failed |= test.sentNs==0 || test.receivedNs < test.sentNs || reactNs > 1000000ULL;
+	failed |= test.resizes != 1;
+	failed |= cpuNs*10 > wallNs; //idle loop is mostly asleep
+
+	kaelEvent_free(&loop);
+	close(test.pipeFd[0]);
+	close(test.pipeFd[1]);
+
+	printf("%s\n", failed ? "FAIL!" : "Success!");
+	printf("kaelEvent_unit Done\n");
+}
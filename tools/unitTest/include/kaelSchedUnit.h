@@ -0,0 +1,71 @@
+/**
+ * @file kaelSchedUnit.h
+ * 
+ * @brief Test main loop scheduler on virtual clock
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "kaelygon/global/kaelMacros.h"
+#include "kaelygon/clock/clock.h"
+#include "kaelygon/sched/sched.h"
+
+//Job that takes its cost in virtual time
+void unitTest_schedWork(void *state){
+	kaelClock_sleep(*(ktime_t *)state);
+}
+
+/**
+ * @brief Run audio, input and render jobs for 4 virtual seconds. Only audio is critical
+ * @return 1 if audio missed or was late, first input run is unmeasured and may delay it
+ */
+uint8_t unitTest_schedRun(ktime_t renderCost, KaelSched_jobStats *audio, KaelSched_jobStats *render){
+	ktime_t audioCost = 40;
+	ktime_t inputCost = 2;
+	const uint16_t seconds = 4;
+
+	KaelSched sched;
+	kaelSched_init(&sched);
+	kaelSched_addJob(&sched, unitTest_schedWork, &audioCost, AUDIO_BUFFER_SIZE, KAEL_SCHED_CRITICAL);
+	kaelSched_addJob(&sched, unitTest_schedWork, &inputCost, TARGET_CLOCK_HZ/256, KAEL_SCHED_LOW);
+	kaelSched_addJob(&sched, unitTest_schedWork, &renderCost, TARGET_CLOCK_HZ/60, KAEL_SCHED_LOW);
+	kaelSched_setCost(&sched, 2, renderCost);
+
+	uint64_t end = kaelSched_getTime(&sched) + (uint64_t)TARGET_CLOCK_HZ*seconds;
+	while(kaelSched_getTime(&sched) < end){
+		kaelSched_runOnce(&sched);
+	}
+
+	kaelSched_getStats(&sched, 0, audio);
+	kaelSched_getStats(&sched, 2, render);
+	printf("Render cost %u: audio runs %u late %u missed %u, render runs %u deferred %u missed %u\n",
+		renderCost, audio->runs, audio->maxLateness, audio->missed, render->runs, render->deferred, render->missed);
+
+	uint32_t audioExpected = (uint32_t)seconds*TARGET_CLOCK_HZ/AUDIO_BUFFER_SIZE;
+	return audio->missed!=0 || audio->runs+1 < audioExpected || audio->maxLateness > inputCost;
+}
+
+void kaelSched_unit(){
+	uint8_t failed = 0;
+	uint8_t realVariant = kaelClock_getVariant();
+	kaelClock_setVariant(KAEL_CLOCK_VIRTUAL);
+
+	KaelSched_jobStats audio, render;
+
+	//Render fits in slack between audio buffers
+	failed |= unitTest_schedRun(150, &audio, &render);
+	failed |= render.runs < 4*60*9/10;
+
+	//Render never fits, audio must not suffer
+	failed |= unitTest_schedRun(230, &audio, &render);
+	failed |= render.runs != 0 || render.missed == 0;
+
+	if(realVariant!=KAEL_CLOCK_UNSET){
+		kaelClock_setVariant(realVariant);
+	}
+	printf("%s\n", failed ? "FAIL!" : "Success!");
+	printf("kaelSched_unit Done\n");
+}
@@ -10,6 +10,7 @@
 
 #include "kaelygon/global/kaelMacros.h"
 #include "kaelygon/string/string.h"
+#include "kaelygon/string/gapStr.h"
 
 
 void kaelString_unit(){
@@ -71,4 +72,62 @@ void kaelString_unit(){
 
 
    printf("kaelString_unit done\n");
-}
\ No newline at end of file
+}
+
+
+
+/**
+ * @brief Gap string edits in the middle match the same edits done on a flat C string
+ */
+void kaelGapStr_unit(){
+	uint8_t pass = 1;
+	KaelGapStr gap;
+	kaelGapStr_alloc(&gap, 8);
+
+	kaelGapStr_insertCstr(&gap, "line0\nline2\n");
+	kaelGapStr_setCursor(&gap, 6);
+	kaelGapStr_insertCstr(&gap, "line1\n");
+	kaelGapStr_setCursor(&gap, UINT16_MAX); //clamped to end
+	kaelGapStr_insertCstr(&gap, "line3");
+
+	uint8_t *flat = kaelGapStr_flatten(&gap);
+	if(strcmp((char *)flat, "line0\nline1\nline2\nline3") != 0){
+		printf("Fail kaelGapStr insert: %s\n", flat);
+		pass = 0;
+	}
+
+	//Backspace and delete around the cursor
+	kaelGapStr_setCursor(&gap, 11);
+	kaelGapStr_erase(&gap, 5);
+	kaelGapStr_eraseForward(&gap, 1);
+	kaelGapStr_insertCstr(&gap, "one ");
+	uint8_t range[32];
+	kaelGapStr_copyRange(&gap, range, 0, sizeof(range)-1);
+	if(strcmp((char *)range, "line0\none line2\nline3") != 0){
+		printf("Fail kaelGapStr erase: %s\n", range);
+		pass = 0;
+	}
+
+	//Visible range across the gap starts from a line
+	uint16_t start = kaelGapStr_lineStart(&gap, 1);
+	uint16_t end = kaelGapStr_lineStart(&gap, 2);
+	kaelGapStr_copyRange(&gap, range, start, end-start);
+	if(start != 6 || strcmp((char *)range, "one line2\n") != 0 || kaelGapStr_lineStart(&gap, 9) != kaelGapStr_length(&gap)){
+		printf("Fail kaelGapStr_lineStart %u %u: %s\n", start, end, range);
+		pass = 0;
+	}
+
+	//Long typing in the middle
+	kaelGapStr_setCursor(&gap, 3);
+	for(uint16_t i=0; i<10000; i++){
+		kaelGapStr_insert(&gap, (const uint8_t *)"x", 1);
+	}
+	if(kaelGapStr_length(&gap) != 10021 || kaelGapStr_get(&gap, 2) != 'n' || kaelGapStr_get(&gap, 10002) != 'x' || kaelGapStr_get(&gap, 10003) != 'e'){
+		printf("Fail kaelGapStr long insert\n");
+		pass = 0;
+	}
+	kaelGapStr_free(&gap);
+
+	printf("%s\n", pass ? "Success!" : "FAIL!");
+	printf("kaelGapStr_unit Done\n");
+}
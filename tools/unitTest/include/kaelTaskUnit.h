@@ -0,0 +1,83 @@
+/**
+ * @file kaelTaskUnit.h
+ * 
+ * @brief Test stackless coroutines
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "kaelygon/global/kaelMacros.h"
+#include "kaelygon/task/task.h"
+
+#define UNIT_TASK_LENGTH 4096U
+
+typedef struct{
+	KaelTask task;
+	KaelTask_budget budget;
+	uint16_t i; //loop state lives here, not on stack
+	uint16_t round;
+	uint16_t hash;
+	uint8_t *data;
+	uint8_t ready; //set by caller to let the task finish
+}UnitTest_taskState;
+
+//Long job, hash the buffer many times
+uint16_t unitTest_taskHash(uint16_t hash, const uint8_t *data, uint16_t length){
+	for(uint16_t i=0; i<length; i++){
+		hash = kaelRand_lcg(hash ^ data[i]);
+	}
+	return hash;
+}
+
+uint8_t unitTest_taskStep(UnitTest_taskState *state){
+	KAEL_TASK_BEGIN(&state->task);
+
+	state->hash = 1;
+	kaelTask_startBudget(&state->budget, KAEL_TASK_BUDGET_TICKS);
+	for(state->round=0; state->round<256; state->round++){
+		for(state->i=0; state->i<UNIT_TASK_LENGTH; state->i+=256){
+			state->hash = unitTest_taskHash(state->hash, state->data + state->i, 256);
+			KAEL_TASK_YIELD_OVER_BUDGET(&state->task, &state->budget);
+		}
+	}
+
+	KAEL_TASK_WAIT_UNTIL(&state->task, state->ready);
+
+	KAEL_TASK_END(&state->task);
+}
+
+void kaelTask_unit(){
+	uint8_t failed = 0;
+
+	uint8_t data[UNIT_TASK_LENGTH];
+	for(uint16_t i=0; i<UNIT_TASK_LENGTH; i++){
+		data[i] = (uint8_t)(i*7);
+	}
+
+	//Reference without yielding
+	uint16_t expected = 1;
+	for(uint16_t r=0; r<256; r++){
+		expected = unitTest_taskHash(expected, data, UNIT_TASK_LENGTH);
+	}
+
+	UnitTest_taskState state = { .data = data };
+	kaelTask_init(&state.task);
+
+	uint16_t yields = 0;
+	while( unitTest_taskStep(&state) == KAEL_TASK_YIELDED ){
+		yields++;
+		state.ready = state.round==256; //hashing done, release the wait
+	}
+
+	printf("Task state %lu bytes, %u yields, hash %u expected %u\n", (unsigned long)sizeof(KaelTask), yields, state.hash, expected);
+	failed |= sizeof(KaelTask) > 2;
+	failed |= yields < 2; //over a million bytes hashed takes several slices
+	failed |= kaelTask_isRunning(&state.task);
+	failed |= state.hash != expected;
+
+	printf("%s\n", failed ? "FAIL!" : "Success!");
+	printf("kaelTask_unit Done\n");
+}
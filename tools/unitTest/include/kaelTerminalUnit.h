@@ -17,8 +17,10 @@
 #include "kaelygon/clock/clock.h" //cpu kaelClock timer 
 #include "kaelygon/terminal/terminal.h" //Text User Interface
 #include "kaelygon/string/string.h" //KaelStr
+#include "kaelygon/mem/arena.h" //KaelArena
 
 #include "kaelygon/terminal/keyID.h" //KEY_ definitions as byte string
+#include "kaelygon/terminal/keyMap.h" //Key bindings
 
 
 #include <time.h>
@@ -28,6 +30,10 @@ clock_t std_clock() {
     return clock();
 }
 
+void kaelTerminal_quitKey(void *state){
+	kaelTui_setQuitFlag(state,1);
+}
+
 void kaelTerminal_unit() {
 
 	kaelTui_rawmode(1); 
@@ -35,18 +41,27 @@ void kaelTerminal_unit() {
 	KaelTui tui;
 	kaelTui_alloc(&tui);
 
+	//Temporary strings live in a stack arena, no heap allocation
+	uint8_t arenaBuffer[512];
+	KaelArena arena;
+	kaelArena_alloc(&arena, sizeof(arenaBuffer), arenaBuffer);
+
 	KaelStr printBuffer;
-	kaelStr_alloc(&printBuffer,128);
+	kaelStr_allocArena(&printBuffer,128,&arena);
 	kaelStr_setCstr(&printBuffer,"Hello world!");
 
 	KaelStr keyStr;
-	kaelStr_alloc(&keyStr,8);
+	kaelStr_allocArena(&keyStr,8,&arena);
+
+	KaelMap keyMap;
+	kaelKeyMap_alloc(&keyMap);
+	kaelKeyMap_bind(&keyMap,KEY_SHIFT_Q,kaelTerminal_quitKey);
 
 	uint8_t charBufCount=3;
 	KaelStr charBuffer[charBufCount];
 	char *charBufPtr[3];
 	for(uint8_t i=0;i<charBufCount;i++){
-		kaelStr_alloc(&charBuffer[i],32);
+		kaelStr_allocArena(&charBuffer[i],32,&arena);
 		charBufPtr[i]=kaelStr_getCharPtr(&charBuffer[i]);
 	}
 
@@ -65,7 +80,7 @@ void kaelTerminal_unit() {
 		kaelTui_getKeyPressStr(&keyStr);
 		
 		if(kaelStr_getEnd(&keyStr)){
-			if( kaelStr_compareCstr(&keyStr,KEY_SHIFT_Q)==128 ){kaelTui_setQuitFlag(&tui,1);}
+			kaelKeyMap_call(&keyMap,&keyStr,&tui);
 			
 			kaelStr_appendCstr(&charBuffer[0],"key{");
 			for(uint16_t i=0;i<kaelStr_getEnd(&keyStr);i++){
@@ -104,10 +119,12 @@ void kaelTerminal_unit() {
 
 	kaelStr_free(&printBuffer);
 	kaelStr_free(&keyStr);
+	kaelKeyMap_free(&keyMap);
 	for(uint8_t i=0;i<charBufCount;i++){
 		kaelStr_free(&charBuffer[i]);
 		charBufPtr[i]=NULL;
 	}
+	kaelArena_free(&arena);
 
 	kaelTui_free(&tui);
 
@@ -120,15 +137,15 @@ void kaelTerminal_unit() {
 
 	printf("%.4f sample discrepency. %.4f seconds\n",deltaRatioAbs*(double)AUDIO_SAMPLE_RATE, deltaRatioAbs*targetTimeRatio);
 	if( deltaRatioAbs > 1.0/kaelClock.tickRate){ // +1 buffer lost
-		printf("Did you set cpu kaelClock speed correctly when using __rdtsc?\n");
+		printf("Is TSC calibration or hybrid clock sleep off?\n");
 	}
 
 	printf("\n");
 	
 
 	printf("AUDIO_SAMPLE_RATE %u\n",AUDIO_SAMPLE_RATE);
-	printf("CLOCK_SPEED_HZ %u\n",CLOCK_SPEED_HZ);
-	printf("CLOCK_TARGET_RATIO %u\n",CLOCK_TARGET_RATIO);
+	printf("Clock variant %u\n",kaelClock_getVariant());
+	printf("TSC ratio %llu\n",kaelClock_rdtsc_getRatio());
 
 	printf("kaelTerminal_unit Done\n");	
 }
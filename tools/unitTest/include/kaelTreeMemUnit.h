@@ -9,10 +9,20 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <string.h>
+#include <stdalign.h>
 
 #include "kaelygon/global/kaelMacros.h"
 
 #include "kaelygon/treeMem/tree.h"
+#include "kaelygon/treeMem/typedTree.h"
+#include "kaelygon/treeMem/bankTree.h"
+#include "kaelygon/treeMem/deque.h"
+#include "kaelygon/treeMem/map.h"
+#include "kaelygon/mem/arena.h"
+#include "kaelygon/mem/pool.h"
+#include "kaelygon/mem/mem.h"
+#include "kaelygon/mem/budget.h"
+#include "kaelygon/string/string.h"
 #include "kaelygon/math/math.h"
 
 typedef struct{
@@ -23,6 +33,9 @@ typedef struct{
 	uint16_t end[2]; //End row and column
 }unitTest_leaf;
 
+KAEL_TREE_DEFINE(unitLeaf, unitTest_leaf)
+KAEL_TREE_DEFINE_SMALL(unitSmall, uint16_t, 8)
+
 void unitTest_treeAlloc(KaelTree *tree, uint16_t branchCount, uint16_t leafCount, uint16_t leafMaxLen){
 	kaelTree_alloc(tree, sizeof(KaelTree)); //Tree holds branches 
 	kaelTree_resize(tree, branchCount); //Resize allocates one chunk at once
@@ -298,4 +311,843 @@ void kaelTree_functions_unit(){
 
 
 	printf("kaelTree_functions_unit Done\n");
-}
\ No newline at end of file
+}
+
+
+
+
+
+
+
+/**
+ * @brief Fill and drain like drawQueue does every frame. Capacity has to settle so steady state doesn't realloc
+ */
+void kaelTree_shrink_unit(){
+	uint8_t pass = 1;
+	KaelTree tree;
+	kaelTree_alloc(&tree, sizeof(uint16_t));
+
+	//Hysteresis, push and pop around one length never changes capacity
+	for(uint16_t i=0; i<100; i++){
+		kaelTree_push(&tree, &i);
+	}
+	uint16_t capacity = tree.capacity;
+	for(uint16_t i=0; i<1000; i++){
+		kaelTree_pop(&tree);
+		kaelTree_push(&tree, &i);
+		if(tree.capacity != capacity){
+			printf("Fail kaelTree_pop hysteresis reallocated at %u\n", i);
+			pass = 0;
+			break;
+		}
+	}
+
+	//Draining a hysteresis tree still releases memory
+	while(!kaelTree_empty(&tree)){
+		kaelTree_pop(&tree);
+	}
+	if(tree.capacity >= capacity){
+		printf("Fail kaelTree_pop hysteresis never shrinks\n");
+		pass = 0;
+	}
+
+	//Never shrink, frames after the first keep the same buffer
+	kaelTree_setShrink(&tree, KAEL_TREE_SHRINK_NEVER);
+	void *frameData = NULL;
+	for(uint16_t frame=0; frame<10; frame++){
+		for(uint16_t i=0; i<300; i++){
+			kaelTree_push(&tree, &i);
+		}
+		if(frame > 0 && tree.data != frameData){
+			printf("Fail KAEL_TREE_SHRINK_NEVER reallocated on frame %u\n", frame);
+			pass = 0;
+			break;
+		}
+		frameData = tree.data;
+		while(!kaelTree_empty(&tree)){
+			kaelTree_pop(&tree);
+		}
+	}
+
+	//Clear keeps capacity, shrinkToFit releases everything beyond length
+	capacity = tree.capacity;
+	kaelTree_pushN(&tree, NULL, 10);
+	kaelTree_clear(&tree);
+	if(!kaelTree_empty(&tree) || tree.capacity != capacity){
+		printf("Fail kaelTree_clear\n");
+		pass = 0;
+	}
+	kaelTree_pushN(&tree, NULL, 10);
+	kaelTree_shrinkToFit(&tree);
+	if(tree.capacity != 10*sizeof(uint16_t) || kaelTree_length(&tree) != 10){
+		printf("Fail kaelTree_shrinkToFit\n");
+		pass = 0;
+	}
+	kaelTree_free(&tree);
+
+	printf("%s\n", pass ? "Success!" : "FAIL!");
+	printf("kaelTree_shrink_unit Done\n");
+}
+
+
+
+
+
+
+/**
+ * @brief Typed tree keeps element addresses and order through growth, bulk push and iteration
+ */
+void kaelTree_typed_unit(){
+	KaelTree_unitLeaf tree;
+	uint8_t pass = 1;
+	kaelTree_unitLeaf_alloc(&tree);
+
+	if(!kaelTree_unitLeaf_empty(&tree) || kaelTree_unitLeaf_begin(&tree)!=kaelTree_unitLeaf_end(&tree)){
+		printf("Fail empty typed tree\n");
+		pass = 0;
+	}
+
+	uint16_t pushCount = 100;
+	for(uint16_t i=0; i<pushCount; i++){
+		unitTest_leaf *leaf = kaelTree_unitLeaf_push(&tree, (unitTest_leaf){ .length = i, .readHead = i*3 });
+		if(leaf==NULL || leaf != kaelTree_unitLeaf_get(&tree, i)){
+			printf("Fail kaelTree_unitLeaf_push at %u\n", i);
+			pass = 0;
+			break;
+		}
+	}
+
+	//Reserve first so emplace doesn't move the bulk elements
+	kaelTree_unitLeaf_reserve(&tree, pushCount+5);
+	unitTest_leaf zeroLeaves[4] = {0};
+	unitTest_leaf *bulk = kaelTree_unitLeaf_pushN(&tree, zeroLeaves, 4);
+	unitTest_leaf *emplaced = kaelTree_unitLeaf_emplace(&tree);
+	if(bulk==NULL || emplaced==NULL || emplaced != bulk+4){
+		printf("Fail kaelTree_unitLeaf_pushN or emplace\n");
+		pass = 0;
+	}else{
+		emplaced->length = UINT16_MAX;
+	}
+	kaelTree_unitLeaf_pop(&tree);
+
+	uint16_t index = 0;
+	KAEL_TREE_FOREACH(leaf, &tree){
+		uint16_t expected = index < pushCount ? index : 0;
+		if(leaf->length != expected || leaf != kaelTree_unitLeaf_get(&tree, index)){
+			printf("Fail KAEL_TREE_FOREACH at %u\n", index);
+			pass = 0;
+			break;
+		}
+		index++;
+	}
+	if(index != pushCount+4 || kaelTree_unitLeaf_length(&tree) != pushCount+4){
+		printf("Fail typed tree length %u\n", index);
+		pass = 0;
+	}
+
+	//Byte size may not pass 16 bits
+	uint16_t maxLength = kaelTree_unitLeaf_maxLength();
+	if(kaelTree_unitLeaf_pushN(&tree, NULL, maxLength) != NULL){
+		printf("Fail typed tree went over %u elements\n", maxLength);
+		pass = 0;
+	}
+
+	kaelTree_unitLeaf_free(&tree);
+
+	printf("%s\n", pass ? "Success!" : "FAIL!");
+	printf("kaelTree_typed_unit Done\n");
+}
+
+
+
+
+
+
+
+/**
+ * @brief Small tree stays inline up to its local size, spills to heap past it and moves back on shrinkToFit
+ */
+void kaelTree_small_unit(){
+	uint8_t pass = 1;
+	KaelTree_unitSmall tree;
+	kaelTree_unitSmall_alloc(&tree);
+
+	for(uint16_t i=0; i<8; i++){
+		kaelTree_unitSmall_push(&tree, i);
+	}
+	if(tree.data != tree.local || kaelTree_unitSmall_length(&tree) != 8){
+		printf("Fail kaelTree_unitSmall allocated within inline size\n");
+		pass = 0;
+	}
+
+	//Past inline size elements are moved to heap in order
+	for(uint16_t i=8; i<100; i++){
+		kaelTree_unitSmall_push(&tree, i);
+	}
+	uint16_t expected = 0;
+	KAEL_TREE_FOREACH(it, &tree){
+		if(*it != expected++){
+			printf("Fail kaelTree_unitSmall spill at %u\n", expected-1);
+			pass = 0;
+			break;
+		}
+	}
+	if(tree.data == tree.local || *kaelTree_unitSmall_back(&tree) != 99){
+		printf("Fail kaelTree_unitSmall didn't spill to heap\n");
+		pass = 0;
+	}
+
+	//Fits inline again after pops
+	while(kaelTree_unitSmall_length(&tree) > 5){
+		kaelTree_unitSmall_pop(&tree);
+	}
+	kaelTree_unitSmall_shrinkToFit(&tree);
+	if(tree.data != tree.local || tree.capacity != 8 || tree.local[4] != 4){
+		printf("Fail kaelTree_unitSmall_shrinkToFit\n");
+		pass = 0;
+	}
+	kaelTree_unitSmall_free(&tree);
+
+	printf("%s\n", pass ? "Success!" : "FAIL!");
+	printf("kaelTree_small_unit Done\n");
+}
+
+
+
+
+
+
+/**
+ * @brief Banked tree holds more than 64 KiB, keeps addresses of full banks and copies across bank edges
+ */
+void kaelTree_bank_unit(){
+	//Odd width so bank length isn't a divisor of 64 KiB
+	typedef struct{ uint8_t a; uint16_t b; uint16_t c; }UnitBankElem;
+	KaelBankTree tree;
+	uint8_t pass = 1;
+	kaelBankTree_alloc(&tree, sizeof(UnitBankElem));
+
+	uint32_t count = 100000;
+	UnitBankElem *firstFull = NULL;
+	for(uint32_t i=0; i<count; i++){
+		UnitBankElem *elem = kaelBankTree_push(&tree, &(UnitBankElem){ .a = i, .b = i>>8, .c = i>>16 });
+		if(elem==NULL){
+			printf("Fail kaelBankTree_push at %u\n", i);
+			pass = 0;
+			break;
+		}
+		if(i == kaelBankTree_bankLength(&tree)){
+			firstFull = elem; //First element of second bank never moves
+		}
+	}
+
+	uint32_t bankLength = kaelBankTree_bankLength(&tree);
+	if(firstFull==NULL || firstFull != kaelBankTree_get(&tree, bankLength)){
+		printf("Fail kaelBankTree address moved\n");
+		pass = 0;
+	}
+
+	//Bulk push straddles a bank edge
+	uint32_t edge = (kaelBankTree_length(&tree) | (bankLength-1)) + 1;
+	uint32_t pad = edge - kaelBankTree_length(&tree) - 3;
+	kaelBankTree_pushN(&tree, NULL, pad);
+	UnitBankElem bulk[6] = {{.a=1},{.a=2},{.a=3},{.a=4},{.a=5},{.a=6}};
+	kaelBankTree_pushN(&tree, bulk, 6);
+
+	UnitBankElem copied[6] = {0};
+	kaelBankTree_copyOut(&tree, copied, edge-3, 6);
+	for(uint8_t i=0; i<6; i++){
+		UnitBankElem *elem = kaelBankTree_get(&tree, edge-3+i);
+		if(elem->a != i+1 || copied[i].a != i+1){
+			printf("Fail kaelBankTree_pushN across banks\n");
+			pass = 0;
+			break;
+		}
+	}
+
+	//Every element is where it was pushed
+	for(uint32_t i=0; i<count; i++){
+		UnitBankElem *elem = kaelBankTree_get(&tree, i);
+		if(elem->a != (uint8_t)i || elem->b != (uint16_t)(i>>8) || elem->c != (uint16_t)(i>>16)){
+			printf("Fail kaelBankTree_get at %u\n", i);
+			pass = 0;
+			break;
+		}
+	}
+
+	//Span never crosses a bank
+	uint32_t spanLength = 0;
+	kaelBankTree_reserveSpan(&tree, bankLength*2, &spanLength);
+	if(spanLength==0 || spanLength > bankLength - (kaelBankTree_length(&tree) & (bankLength-1))){
+		printf("Fail kaelBankTree_reserveSpan %u\n", spanLength);
+		pass = 0;
+	}
+
+	uint32_t total = 0;
+	uint32_t used = 0;
+	for(uint16_t b=0; kaelBankTree_getBank(&tree, b, &used); b++){
+		total += used;
+	}
+	if(total != kaelBankTree_length(&tree) || (uint64_t)total*sizeof(UnitBankElem) <= UINT16_MAX){
+		printf("Fail kaelBankTree_getBank total %u\n", total);
+		pass = 0;
+	}
+
+	kaelBankTree_free(&tree);
+
+	printf("%s\n", pass ? "Success!" : "FAIL!");
+	printf("kaelTree_bank_unit Done\n");
+}
+
+
+
+
+
+
+/**
+ * @brief Deque keeps element addresses through growth at both ends and reuses map in FIFO use
+ */
+void kaelDeque_unit(){
+	KaelDeque deque;
+	uint8_t pass = 1;
+	kaelDeque_alloc(&deque, sizeof(unitTest_leaf));
+
+	//Pointer to the first element, like a queued shape pointer
+	unitTest_leaf *first = kaelDeque_pushBack(&deque, &(unitTest_leaf){ .length = 0 });
+
+	uint16_t pushCount = 5000;
+	for(uint16_t i=1; i<pushCount; i++){
+		kaelDeque_pushBack(&deque, &(unitTest_leaf){ .length = i });
+		kaelDeque_pushFront(&deque, &(unitTest_leaf){ .length = UINT16_MAX - i });
+	}
+	if(first->length != 0 || first != kaelDeque_get(&deque, pushCount-1)){
+		printf("Fail kaelDeque element moved\n");
+		pass = 0;
+	}
+
+	//Front half is descending from the far end, back half ascending
+	uint32_t length = kaelDeque_length(&deque);
+	for(uint32_t i=0; i<length; i++){
+		unitTest_leaf *leaf = kaelDeque_get(&deque, i);
+		uint16_t expected = i < (uint32_t)(pushCount-1) ? UINT16_MAX - (pushCount-1 - i) : i - (pushCount-1);
+		if(leaf->length != expected){
+			printf("Fail kaelDeque_get at %u\n", i);
+			pass = 0;
+			break;
+		}
+	}
+
+	//Spans cover every element exactly once
+	uint32_t total = 0;
+	while(total < length){
+		uint32_t count = 0;
+		unitTest_leaf *span = kaelDeque_getSpan(&deque, total, &count);
+		if(count==0 || span != kaelDeque_get(&deque, total)){
+			printf("Fail kaelDeque_getSpan\n");
+			pass = 0;
+			break;
+		}
+		total += count;
+	}
+
+	//Long FIFO run recenters the map instead of growing it
+	kaelDeque_clear(&deque);
+	uint16_t mapSlots = deque.mapSlots;
+	for(uint32_t i=0; i<200000; i++){
+		kaelDeque_pushBack(&deque, &(unitTest_leaf){ .length = i });
+		if(kaelDeque_length(&deque) > 64){
+			kaelDeque_popFront(&deque);
+		}
+	}
+	unitTest_leaf *front = kaelDeque_front(&deque);
+	unitTest_leaf *back = kaelDeque_back(&deque);
+	if(deque.mapSlots != mapSlots || front->length != (uint16_t)(200000-64) || back->length != (uint16_t)(200000-1)){
+		printf("Fail kaelDeque FIFO, map %u slots\n", deque.mapSlots);
+		pass = 0;
+	}
+
+	while(!kaelDeque_empty(&deque)){
+		kaelDeque_popBack(&deque);
+	}
+	kaelDeque_free(&deque);
+
+	printf("%s\n", pass ? "Success!" : "FAIL!");
+	printf("kaelDeque_unit Done\n");
+}
+
+
+
+
+
+
+/**
+ * @brief Test bump arena
+ * 
+ * Allocations are aligned, rollback releases only what came after the mark,
+ * latest allocation grows in place and tree and string can live in a caller provided buffer
+ */
+void kaelArena_unit(){
+	uint8_t pass = 1;
+	_Alignas(KAEL_ARENA_ALIGN) uint8_t buffer[4096];
+	KaelArena arena;
+	kaelArena_alloc(&arena, sizeof(buffer), buffer);
+
+	uint8_t *odd = kaelArena_push(&arena, 3);
+	uint8_t *aligned = kaelArena_push(&arena, 8);
+	if(odd==NULL || aligned==NULL || ((uintptr_t)aligned & (KAEL_ARENA_ALIGN-1)) || aligned < odd+3){
+		printf("Fail kaelArena_push alignment\n");
+		pass = 0;
+	}
+
+	//Rollback releases everything after the mark and nothing before it
+	KaelArena_mark mark = kaelArena_mark(&arena);
+	kaelArena_pushZero(&arena, 1000);
+	kaelArena_rollback(&arena, mark);
+	if(kaelArena_getUsed(&arena) != mark || kaelArena_getHighWater(&arena) < mark+1000){
+		printf("Fail kaelArena_rollback\n");
+		pass = 0;
+	}
+
+	//Latest allocation grows in place, older one is copied
+	uint8_t *grow = kaelArena_push(&arena, 16);
+	memset(grow, 7, 16);
+	uint8_t *grown = kaelArena_resize(&arena, grow, 16, 64);
+	uint8_t *moved = kaelArena_resize(&arena, aligned, 8, 64);
+	if(grown != grow || moved == aligned || moved == NULL || grown[15] != 7){
+		printf("Fail kaelArena_resize\n");
+		pass = 0;
+	}
+
+	if(kaelArena_push(&arena, sizeof(buffer)) != NULL){
+		printf("Fail kaelArena_push beyond size\n");
+		pass = 0;
+	}
+	kaelArena_reset(&arena);
+
+	//Tree grows inside the arena
+	KaelTree tree;
+	kaelTree_allocArena(&tree, sizeof(uint16_t), &arena);
+	for(uint16_t i=0; i<500; i++){
+		kaelTree_push(&tree, &i);
+	}
+	uint8_t *treeData = tree.data;
+	if(kaelTree_length(&tree) != 500 || *(uint16_t *)kaelTree_get(&tree, 499) != 499 
+		|| treeData < buffer || treeData >= buffer + sizeof(buffer)){
+		printf("Fail kaelTree_allocArena\n");
+		pass = 0;
+	}
+	kaelTree_free(&tree);
+
+	//String grows in place after the tree
+	KaelStr kstr;
+	kaelStr_allocArena(&kstr, 8, &arena);
+	kaelStr_resize(&kstr, 32);
+	kaelStr_setCstr(&kstr, "Arena string");
+	if(kaelStr_compareCstr(&kstr, "Arena string") != 0){
+		printf("Fail kaelStr_allocArena\n");
+		pass = 0;
+	}
+	kaelStr_free(&kstr);
+
+	kaelArena_reset(&arena);
+	if(kaelArena_getUsed(&arena) != 0){
+		printf("Fail kaelArena_reset\n");
+		pass = 0;
+	}
+	kaelArena_free(&arena);
+
+	printf("%s\n", pass ? "Success!" : "FAIL!");
+	printf("kaelArena_unit Done\n");
+}
+
+
+
+
+
+
+
+/**
+ * @brief Test fixed size slot pool
+ * 
+ * Released slots are reused, stale handles are rejected with generation bits and a full pool fails without allocating
+ */
+void kaelPool_unit(){
+	uint8_t pass = 1;
+	KaelPool pool;
+	uint16_t capacity = 100;
+	kaelPool_alloc(&pool, sizeof(unitTest_leaf), capacity, 4, NULL);
+
+	KaelPool_handle handle[100];
+	for(uint16_t i=0; i<capacity; i++){
+		handle[i] = kaelPool_acquire(&pool);
+		unitTest_leaf *leaf = kaelPool_get(&pool, handle[i]);
+		if(leaf==NULL || leaf->length != 0){
+			printf("Fail kaelPool_acquire at %u\n", i);
+			pass = 0;
+			break;
+		}
+		leaf->length = i;
+	}
+	if(kaelPool_acquire(&pool) != KAEL_POOL_INVALID || kaelPool_used(&pool) != capacity){
+		printf("Fail kaelPool full\n");
+		pass = 0;
+	}
+
+	//Release every other slot, stale handles no longer resolve
+	for(uint16_t i=0; i<capacity; i+=2){
+		kaelPool_release(&pool, handle[i]);
+	}
+	for(uint16_t i=0; i<capacity; i++){
+		unitTest_leaf *leaf = kaelPool_get(&pool, handle[i]);
+		uint8_t expectLive = i&1;
+		if((leaf!=NULL) != expectLive || (leaf!=NULL && leaf->length != i)){
+			printf("Fail kaelPool_get after release at %u\n", i);
+			pass = 0;
+			break;
+		}
+	}
+
+	//Reacquired slots reuse released memory but get new handles
+	for(uint16_t i=0; i<capacity; i+=2){
+		KaelPool_handle newHandle = kaelPool_acquire(&pool);
+		if(newHandle == KAEL_POOL_INVALID || newHandle == handle[i] || kaelPool_valid(&pool, handle[i])){
+			printf("Fail kaelPool reuse\n");
+			pass = 0;
+			break;
+		}
+	}
+	if(kaelPool_acquire(&pool) != KAEL_POOL_INVALID){
+		printf("Fail kaelPool reuse grew pool\n");
+		pass = 0;
+	}
+	kaelPool_free(&pool);
+
+	//Caller buffer without generations, largest capacity
+	uint8_t buffer[256*sizeof(uint16_t)];
+	if(kaelPool_alloc(&pool, sizeof(uint8_t), 255, 0, buffer) != KAEL_SUCCESS || kaelPool_bufferBytes(sizeof(uint8_t), 255, 0) > sizeof(buffer)){
+		printf("Fail kaelPool_alloc buffer\n");
+		pass = 0;
+	}
+	KaelPool_handle first = kaelPool_acquire(&pool);
+	kaelPool_release(&pool, first);
+	if(kaelPool_acquire(&pool) != first || (uint8_t *)kaelPool_get(&pool, first) != buffer){
+		printf("Fail kaelPool free list\n");
+		pass = 0;
+	}
+	kaelPool_free(&pool);
+
+	if(kaelPool_alloc(&pool, 8, UINT16_MAX, 1, NULL) == KAEL_SUCCESS){
+		printf("Fail kaelPool_alloc capacity beyond index bits\n");
+		pass = 0;
+		kaelPool_free(&pool);
+	}
+
+	printf("%s\n", pass ? "Success!" : "FAIL!");
+	printf("kaelPool_unit Done\n");
+}
+
+/**
+ * @brief Test Robin Hood hash map
+ * 
+ * Map grows from the smallest table, set overwrites or keeps values, odd keys survive removal of even keys,
+ * slot iteration visits every key once and the largest table refuses keys past 7/8 load
+ */
+void kaelMap_unit(){
+	uint8_t pass = 1;
+	KaelMap map;
+	kaelMap_alloc(&map, sizeof(uint32_t), sizeof(uint16_t), 0);
+
+	//Keys spread over the 32-bit range, map grows from the smallest table
+	const uint16_t count = 5000;
+	for(uint16_t i=0; i<count; i++){
+		uint32_t key = (uint32_t)i * 2654435761U;
+		uint16_t *value = kaelMap_set(&map, &key, &i);
+		if(value==NULL || *value != i){
+			printf("Fail kaelMap_set at %u\n", i);
+			pass = 0;
+			break;
+		}
+	}
+	if(kaelMap_length(&map) != count){
+		printf("Fail kaelMap_length %u\n", kaelMap_length(&map));
+		pass = 0;
+	}
+
+	//Setting an existing key overwrites, NULL value keeps it
+	uint32_t key = 7U * 2654435761U;
+	uint16_t value = 1234;
+	kaelMap_set(&map, &key, &value);
+	uint16_t *kept = kaelMap_set(&map, &key, NULL);
+	if(kept==NULL || *kept != 1234 || kaelMap_length(&map) != count){
+		printf("Fail kaelMap_set overwrite\n");
+		pass = 0;
+	}
+	value = 7;
+	kaelMap_set(&map, &key, &value);
+
+	//Remove even keys, odd keys keep their values after the backward shifts
+	for(uint16_t i=0; i<count; i+=2){
+		key = (uint32_t)i * 2654435761U;
+		if(kaelMap_remove(&map, &key) != KAEL_SUCCESS){
+			printf("Fail kaelMap_remove at %u\n", i);
+			pass = 0;
+			break;
+		}
+	}
+	for(uint16_t i=0; i<count; i++){
+		key = (uint32_t)i * 2654435761U;
+		uint16_t *found = kaelMap_get(&map, &key);
+		uint8_t expectFound = i&1;
+		if((found!=NULL) != expectFound || (found!=NULL && *found != i)){
+			printf("Fail kaelMap_get after remove at %u\n", i);
+			pass = 0;
+			break;
+		}
+	}
+	key = 0;
+	if(kaelMap_remove(&map, &key) != KAEL_ERR_NULL){
+		printf("Fail kaelMap_remove missing key\n");
+		pass = 0;
+	}
+
+	//Slot iteration visits every key once
+	uint16_t used = 0;
+	for(uint16_t i=0; i<kaelMap_capacity(&map); i++){
+		uint32_t *slotKey = kaelMap_slotKey(&map, i);
+		if(slotKey==NULL){continue;}
+		uint16_t *slotValue = kaelMap_slotValue(&map, i);
+		used++;
+		if(*slotKey != (uint32_t)(*slotValue) * 2654435761U){
+			printf("Fail kaelMap slot pair at %u\n", i);
+			pass = 0;
+			break;
+		}
+	}
+	if(used != kaelMap_length(&map) || used != count/2){
+		printf("Fail kaelMap slot iteration %u\n", used);
+		pass = 0;
+	}
+
+	kaelMap_clear(&map);
+	key = 1U * 2654435761U;
+	if(kaelMap_length(&map) != 0 || kaelMap_get(&map, &key) != NULL){
+		printf("Fail kaelMap_clear\n");
+		pass = 0;
+	}
+	kaelMap_free(&map);
+
+	//Largest map fills 7/8 of 16-bit slot indices, then refuses more keys
+	kaelMap_alloc(&map, sizeof(uint16_t), 0, 0);
+	uint16_t fit = KAEL_MAP_SLOTS_MAX / 8U * 7U;
+	for(uint16_t i=0; i<fit; i++){
+		if(kaelMap_set(&map, &i, NULL)==NULL){
+			printf("Fail kaelMap fill at %u\n", i);
+			pass = 0;
+			break;
+		}
+	}
+	if(kaelMap_set(&map, &fit, NULL) != NULL || kaelMap_capacity(&map) != KAEL_MAP_SLOTS_MAX){
+		printf("Fail kaelMap full\n");
+		pass = 0;
+	}
+	kaelMap_free(&map);
+
+	printf("%s\n", pass ? "Success!" : "FAIL!");
+	printf("kaelMap_unit Done\n");
+}
+
+/**
+ * @brief Tracked calls move live and peak bytes of their own tag and the total. Counters are compared as deltas
+ * since trees and strings built with KAEL_MEM_TRACK count into the same globals
+ */
+void kaelMem_unit(){
+	uint8_t pass = 1;
+	KaelMem_stats audioBefore = kaelMem_getStats(KAEL_MEM_AUDIO);
+	KaelMem_stats totalBefore = kaelMem_getTotal();
+
+	uint8_t *first = kaelMem_malloc(KAEL_MEM_AUDIO, 100);
+	uint8_t *second = kaelMem_calloc(KAEL_MEM_AUDIO, 50, 2);
+	KaelMem_stats audio = kaelMem_getStats(KAEL_MEM_AUDIO);
+	if(first==NULL || second==NULL || audio.live - audioBefore.live != 200 || audio.allocs - audioBefore.allocs != 2){
+		printf("Fail kaelMem_malloc live %zu\n", audio.live - audioBefore.live);
+		pass = 0;
+	}
+	for(uint8_t i=0; second!=NULL && i<100; i++){
+		if(second[i]!=0){
+			printf("Fail kaelMem_calloc not zeroed\n");
+			pass = 0;
+			break;
+		}
+	}
+	if((uintptr_t)first % alignof(max_align_t) != 0){
+		printf("Fail kaelMem_malloc alignment\n");
+		pass = 0;
+	}
+
+	//Realloc keeps the original tag and contents, hot flag counts it separately
+	memset(first, 7, 100);
+	kaelMem_setHot(1);
+	uint8_t *grown = kaelMem_realloc(KAEL_MEM_OTHER, first, 300);
+	kaelMem_setHot(0);
+	audio = kaelMem_getStats(KAEL_MEM_AUDIO);
+	if(grown==NULL || grown[99]!=7 || audio.live - audioBefore.live != 400
+		|| audio.reallocs - audioBefore.reallocs != 1 || audio.hotReallocs - audioBefore.hotReallocs != 1){
+		printf("Fail kaelMem_realloc\n");
+		pass = 0;
+	}
+	first = grown==NULL ? first : grown;
+
+	kaelMem_free(first);
+	kaelMem_free(second);
+	kaelMem_free(NULL);
+	audio = kaelMem_getStats(KAEL_MEM_AUDIO);
+	KaelMem_stats total = kaelMem_getTotal();
+	if(audio.live != audioBefore.live || audio.frees - audioBefore.frees != 2 || total.live != totalBefore.live){
+		printf("Fail kaelMem_free live %zu\n", audio.live);
+		pass = 0;
+	}
+	if(audio.peak < audioBefore.live + 400 || total.peak < totalBefore.live + 400){
+		printf("Fail kaelMem peak\n");
+		pass = 0;
+	}
+
+	//First growth from NULL is an alloc, not a realloc
+	kaelMem_setHot(1);
+	uint8_t *fromNull = kaelMem_realloc(KAEL_MEM_AUDIO, NULL, 16);
+	kaelMem_setHot(0);
+	KaelMem_stats afterNull = kaelMem_getStats(KAEL_MEM_AUDIO);
+	if(fromNull==NULL || afterNull.allocs - audio.allocs != 1 || afterNull.reallocs != audio.reallocs || afterNull.hotReallocs != audio.hotReallocs){
+		printf("Fail kaelMem_realloc from NULL\n");
+		pass = 0;
+	}
+	kaelMem_free(fromNull);
+
+	kaelMem_report(stdout);
+	printf("%s\n", pass ? "Success!" : "FAIL!");
+	printf("kaelMem_unit Done\n");
+}
+
+/**
+ * @brief Test banked memory budget
+ * 
+ * Blocks are placed first fit within 64 KiB banks, released holes are merged back into whole banks,
+ * an acquire that fits no hole fails and is counted, blocks larger than a bank span empty banks,
+ * resize grows in place when the next block is free and zero bytes still gets its own data granule
+ */
+void kaelBudget_unit(){
+	uint8_t pass = 1;
+	KaelBudget budget;
+	const uint16_t bankCount = 3;
+	if(kaelBudget_alloc(&budget, bankCount, NULL) != KAEL_SUCCESS){
+		printf("Fail kaelBudget_alloc\n");
+		printf("FAIL!\n");
+		return;
+	}
+
+	//1000 bytes + header is 64 granules, 64 blocks fill a bank
+	const uint16_t count = 100;
+	uint8_t *block[100];
+	for(uint16_t i=0; i<count; i++){
+		block[i] = kaelBudget_acquire(&budget, 1000);
+		if(block[i]==NULL || (uintptr_t)block[i] % KAEL_BUDGET_GRANULE != 0){
+			printf("Fail kaelBudget_acquire at %u\n", i);
+			pass = 0;
+			break;
+		}
+		memset(block[i], (uint8_t)i, 1000);
+	}
+	if(!pass){
+		kaelBudget_free(&budget);
+		printf("FAIL!\n");
+		return;
+	}
+	if(block[1] - block[0] != 1024 || kaelBudget_getStats(&budget).banksUsed != 2){
+		printf("Fail kaelBudget first fit\n");
+		pass = 0;
+	}
+
+	//Holes of 1000 bytes and a 28 KiB tail after block 99, a bank sized block only fits the empty bank
+	for(uint16_t i=0; i<count; i+=2){
+		kaelBudget_release(&budget, block[i]);
+	}
+	KaelBudget_stats stats = kaelBudget_getStats(&budget);
+	if(stats.freeBlocks != 52 || stats.largestFree != KAEL_BUDGET_BANK_BYTES - KAEL_BUDGET_GRANULE || stats.fragmentation == 0){
+		printf("Fail kaelBudget holes, %u blocks, largest %zu\n", stats.freeBlocks, stats.largestFree);
+		pass = 0;
+	}
+	uint8_t *whole = kaelBudget_acquire(&budget, KAEL_BUDGET_BANK_BYTES - KAEL_BUDGET_GRANULE);
+	if(whole != budget.region + 2U*KAEL_BUDGET_BANK_BYTES + KAEL_BUDGET_GRANULE){
+		printf("Fail kaelBudget whole bank\n");
+		pass = 0;
+	}
+	if(kaelBudget_acquire(&budget, 30000) != NULL || kaelBudget_getStats(&budget).failures != 1){
+		printf("Fail kaelBudget exhausted\n");
+		pass = 0;
+	}
+	for(uint16_t i=1; i<count; i+=2){
+		if(block[i][999] != (uint8_t)i){
+			printf("Fail kaelBudget block %u overwritten\n", i);
+			pass = 0;
+			break;
+		}
+	}
+
+	//Releasing every block merges each bank back into one free block
+	kaelBudget_release(&budget, whole);
+	for(uint16_t i=1; i<count; i+=2){
+		kaelBudget_release(&budget, block[i]);
+	}
+	stats = kaelBudget_getStats(&budget);
+	if(stats.used != 0 || stats.freeBlocks != bankCount || stats.fragmentation != 0 || stats.peak < 100U*1024U){
+		printf("Fail kaelBudget merge, %u blocks\n", stats.freeBlocks);
+		pass = 0;
+	}
+
+	//Larger than a bank spans consecutive empty banks
+	uint8_t *span = kaelBudget_acquire(&budget, 2U*KAEL_BUDGET_BANK_BYTES);
+	if(span==NULL || kaelBudget_acquire(&budget, 2U*KAEL_BUDGET_BANK_BYTES) != NULL){
+		printf("Fail kaelBudget span\n");
+		pass = 0;
+	}
+	kaelBudget_release(&budget, span);
+
+	//Resize grows into the next free block in place, otherwise moves
+	uint8_t *first = kaelBudget_acquire(&budget, 100);
+	uint8_t *second = kaelBudget_acquire(&budget, 100);
+	memset(first, 3, 100);
+	uint8_t *moved = kaelBudget_resize(&budget, first, 500);
+	if(moved==NULL || moved==first || moved[99]!=3){
+		printf("Fail kaelBudget_resize move\n");
+		pass = 0;
+	}
+	kaelBudget_release(&budget, second);
+	uint8_t *grown = kaelBudget_resize(&budget, first==moved ? second : moved, 5000);
+	if(grown==NULL || grown!=moved || grown[99]!=3){
+		printf("Fail kaelBudget_resize in place\n");
+		pass = 0;
+	}
+	kaelBudget_release(&budget, grown);
+	if(kaelBudget_getStats(&budget).used != 0){
+		printf("Fail kaelBudget_resize used\n");
+		pass = 0;
+	}
+
+	//Zero bytes points at its own granule, not at the header of the next block
+	uint8_t *empty = kaelBudget_acquire(&budget, 0);
+	uint8_t *after = kaelBudget_acquire(&budget, 16);
+	if(empty==NULL || after==NULL || after - empty != 2*KAEL_BUDGET_GRANULE){
+		printf("Fail kaelBudget_acquire zero bytes\n");
+		pass = 0;
+	}
+	kaelBudget_release(&budget, empty);
+	kaelBudget_release(&budget, after);
+	if(kaelBudget_getStats(&budget).used != 0){
+		printf("Fail kaelBudget zero bytes used\n");
+		pass = 0;
+	}
+
+	kaelBudget_report(&budget, stdout);
+	kaelBudget_free(&budget);
+	printf("%s\n", pass ? "Success!" : "FAIL!");
+	printf("kaelBudget_unit Done\n");
+}
@@ -99,4 +99,59 @@ void krleTGA_unit(){
 
 
 	printf("unitTest_krleTGA Done\n");	
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Encode image larger than 64 KiB of KRLE, decode it and encode again. Both strings should be identical
+ */
+void krleTGA_bank_unit(){
+	const uint16_t width = 1024;
+	const uint16_t height = 512;
+
+	uint8_t *pixels = malloc((uint32_t)width*height*4);
+	if(pixels==NULL){return;}
+	uint16_t seed = 1;
+	for(uint32_t i=0; i<(uint32_t)width*height; i++){
+		seed = kaelRand_lcg(seed);
+		Krle_RGB rgb = krle_orchisPalette[seed>>12];
+		pixels[i*4+0] = rgb.b;
+		pixels[i*4+1] = rgb.g;
+		pixels[i*4+2] = rgb.r;
+		pixels[i*4+3] = (seed & 0x1F)==0 ? 0 : 255;
+	}
+
+	Krle_LAB paletteLAB[KRLE_PALETTE_SIZE];
+	krle_paletteRGBToLAB(krle_orchisPalette, paletteLAB, KRLE_PALETTE_SIZE);
+
+	KaelBankTree firstTree, secondTree;
+	kaelBankTree_alloc(&firstTree, sizeof(uint8_t));
+	kaelBankTree_alloc(&secondTree, sizeof(uint8_t));
+	krle_pixelsToKRLE(&firstTree, paletteLAB, pixels, width, height, 1, KRLE_NEAREST);
+
+	uint32_t length = kaelBankTree_length(&firstTree);
+	uint8_t *KRLEString = malloc(length);
+	uint8_t *decoded = NULL;
+	if(!NULL_CHECK(KRLEString)){
+		kaelBankTree_copyOut(&firstTree, KRLEString, 0, length);
+		Krle_header header = krle_createKRLEHeader(width, height, length, 1);
+		krle_KRLEToPixels(KRLEString, &decoded, header);
+		if(decoded!=NULL){
+			krle_pixelsToKRLE(&secondTree, paletteLAB, decoded, width, height, 1, KRLE_NEAREST);
+		}
+	}
+
+	uint8_t pass = length > UINT16_MAX && length == kaelBankTree_length(&secondTree);
+	for(uint32_t i=0; pass && i<length; i++){
+		pass = *(uint8_t *)kaelBankTree_get(&firstTree, i) == *(uint8_t *)kaelBankTree_get(&secondTree, i);
+	}
+	printf("%u byte KRLE string\n", length);
+	printf("%s\n", pass ? "Success!" : "FAIL!");
+
+	KAEL_FREE(decoded); //allocated by krle_KRLEToPixels
+	free(KRLEString);
+	free(pixels);
+	kaelBankTree_free(&firstTree);
+	kaelBankTree_free(&secondTree);
+
+	printf("krleTGA_bank_unit Done\n");
+}
@@ -15,18 +15,45 @@
 #include "./include/kaelTerminalUnit.h"
 #include "./include/kaelStringUnit.h"
 #include "./include/krleConvert.h"
+#include "./include/kaelAudioUnit.h"
+#include "./include/kaelClockUnit.h"
+#include "./include/kaelSchedUnit.h"
+#include "./include/kaelEventUnit.h"
+#include "./include/kaelTaskUnit.h"
 
 //Some tests result is irrelevant as there's no checks of the result correctness.  
 //Mainly these made to find any unintentional NULL values (generated/kael.log) or valgrind errors
 //Could be better, but I rather spend the time writing the actual program than testing 
 void unitTest_runTests(){
 	void(*unitTest_func[])() = {
+		kaelClock_calibrate_unit, //TSC calibration is fast and calibrated sleep matches monotonic clock
+		kaelClock_virtual_unit, //Minutes of virtual ticks run instantly and advance exactly one buffer each
+		kaelClock_drift_unit, //Clock catches up with monotonic time after a stall
+		kaelSched_unit, //Render runs in slack between audio buffers, audio is never late
+		kaelEvent_unit, //Idle epoll loop ticks on timerfd, reacts to fd and SIGWINCH without spinning
+		kaelTask_unit, //Coroutine yields on time budget and gives the same result as an uninterrupted run
 		kaelTerminal_unit, //Test clock in terminal loop example. Fails if kaelClock deviates too much from std clock(). 
 		kaelTree_drawSquares_unit, //Print ascii squares stored in branched kaelTree.
 		kaelTree_functions_unit, //Good test. Stores element, iterate, insert and compare if the data and pointers are unchanged.
+		kaelTree_shrink_unit, //Fill and drain reaches a steady state capacity, clear and shrinkToFit
+		kaelTree_typed_unit, //Typed tree keeps order and addresses through growth, bulk push and KAEL_TREE_FOREACH
+		kaelTree_small_unit, //Small tree spills from inline storage to heap and back
+		kaelTree_bank_unit, //Banked tree holds more than 64 KiB and copies across bank edges
+		kaelDeque_unit, //Deque element addresses survive pushes at both ends
+		kaelArena_unit, //Arena rollback, in place growth and tree and string in a stack buffer
+		kaelPool_unit, //Pool reuses released slots and rejects stale handles
+		kaelMap_unit, //Map finds every key after growth and removes, fills 7/8 of 16-bit slots
+		kaelMem_unit, //Tagged allocations count live, peak and hot reallocs per subsystem
+		kaelBudget_unit, //Budget banks merge freed blocks, fail the same acquire once exhausted
 		kaelString_unit,
+		kaelGapStr_unit, //Gap string edits at cursor match flat string edits, visible line range copies across gap
 		kaelRand_unit,
 		krleTGA_unit, //Good test. Convert TGA->KRLE->TGA twice and compare the results
+		krleTGA_bank_unit, //KRLE string over 64 KiB survives encode->decode->encode
+		kaelAudio_effect_unit, //Echo of an impulse repeats at delay length and decays
+		kaelAudio_mixer_unit, //Threaded and single thread mix have to be bit-identical
+		kaelAudio_command_unit, //Queued commands change track state on their exact sample
+		kaelAudio_adaptive_unit, //Simulated underruns grow output buffer count
 	};
 	uint16_t unitTestCount = sizeof(unitTest_func)/sizeof(unitTest_func[0]);
 
@@ -41,6 +68,9 @@ int main(int argc, char *argv[]){
 	if(argc>0){
 		kaelDebug_alloc(argv[0]);
 	}
+	#if KAEL_MEM_WRAP==1
+		kaelMem_reportAtExit();
+	#endif
 
 	unitTest_runTests();
 